@@ -0,0 +1,93 @@
+#include "Atlas/SkylinePacker.h"
+#include "StdC.h"
+#include <cmath>
+
+namespace {
+	struct Rect {
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	int failures = 0;
+
+	void check(bool condition, const char* message) {
+		if (!condition) {
+			std::cerr << "failed: " << message << std::endl;
+			failures++;
+		}
+	}
+
+	bool overlaps(const Rect& a, const Rect& b) {
+		return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+	}
+
+	// small lcg so every run packs the same sequence
+	uint32_t nextRandom(uint32_t* state) {
+		*state = *state * 1664525u + 1013904223u;
+		return *state >> 16;
+	}
+
+	void testRandomRects() {
+		const uint32_t size = 512;
+		litter::SkylinePacker packer(size, size);
+		std::vector<Rect> rects;
+		uint64_t area = 0;
+		uint32_t state = 1;
+
+		// keeps going past the first miss, smaller rects can still fit the gaps
+		for (int i = 0; i < 2000; i++) {
+			Rect rect;
+			rect.width = 1 + nextRandom(&state) % 64;
+			rect.height = 1 + nextRandom(&state) % 64;
+			if (!packer.insert(rect.width, rect.height, &rect.x, &rect.y)) {
+				continue;
+			}
+			rects.push_back(rect);
+			area += static_cast<uint64_t>(rect.width) * rect.height;
+		}
+
+		check(rects.size() > 100, "random rects mostly fit");
+		for (size_t i = 0; i < rects.size(); i++) {
+			check(rects[i].x + rects[i].width <= size && rects[i].y + rects[i].height <= size, "rect stays inside the atlas");
+			for (size_t j = i + 1; j < rects.size(); j++) {
+				check(!overlaps(rects[i], rects[j]), "rects don't overlap");
+			}
+		}
+
+		float occupancy = static_cast<float>(static_cast<double>(area) / (size * size));
+		check(fabsf(packer.getOccupancy() - occupancy) < 1e-6f, "occupancy matches the packed area");
+		check(packer.getOccupancy() > 0.5f, "occupancy above half");
+	}
+
+	void testEdges() {
+		litter::SkylinePacker packer(64, 32);
+		uint32_t x = 7;
+		uint32_t y = 7;
+
+		check(!packer.insert(65, 1, &x, &y), "too wide is rejected");
+		check(!packer.insert(1, 33, &x, &y), "too tall is rejected");
+		check(x == 7 && y == 7, "a rejected rect leaves the outputs alone");
+		check(packer.getOccupancy() == 0.0f, "a rejected rect takes no space");
+
+		check(packer.insert(64, 32, &x, &y) && x == 0 && y == 0, "an exact fit goes at the origin");
+		check(!packer.insert(1, 1, &x, &y), "a full atlas rejects everything");
+
+		packer.reset();
+		check(packer.getOccupancy() == 0.0f, "reset clears the occupancy");
+		check(packer.insert(32, 32, &x, &y) && x == 0 && y == 0, "reset starts over at the origin");
+		check(packer.insert(32, 32, &x, &y) && x == 32 && y == 0, "the next rect goes beside the first");
+	}
+}
+
+int main() {
+	testRandomRects();
+	testEdges();
+
+	if (failures > 0) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
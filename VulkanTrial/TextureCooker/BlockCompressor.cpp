@@ -0,0 +1,356 @@
+#include "BlockCompressor.h"
+#include "Thread/ThreadPool.h"
+#include "StdC.h"
+#include <vulkan/vulkan.h>
+
+namespace litter {
+	namespace {
+		// block rows per task, small enough to balance across the pool on the smaller levels
+		const uint32_t BLOCK_ROWS_PER_TASK = 8;
+
+		const uint32_t BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		// the ends of the bounding box diagonal that follows the block's dominant channel,
+		// channels that fall while the dominant one rises get their ends swapped
+		void fitEndpoints(const uint8_t* block, uint32_t channelCount, int* low, int* high) {
+			int mean[4] = { 0, 0, 0, 0 };
+			for (uint32_t c = 0; c < channelCount; c++) {
+				low[c] = 255;
+				high[c] = 0;
+				for (uint32_t i = 0; i < 16; i++) {
+					int value = block[i * 4 + c];
+					low[c] = (std::min)(low[c], value);
+					high[c] = (std::max)(high[c], value);
+					mean[c] += value;
+				}
+				mean[c] /= 16;
+			}
+
+			uint32_t dominant = 0;
+			for (uint32_t c = 1; c < channelCount; c++) {
+				if (high[c] - low[c] > high[dominant] - low[dominant]) {
+					dominant = c;
+				}
+			}
+			for (uint32_t c = 0; c < channelCount; c++) {
+				if (c == dominant) {
+					continue;
+				}
+				int covariance = 0;
+				for (uint32_t i = 0; i < 16; i++) {
+					covariance += (block[i * 4 + dominant] - mean[dominant]) * (block[i * 4 + c] - mean[c]);
+				}
+				if (covariance < 0) {
+					std::swap(low[c], high[c]);
+				}
+			}
+		}
+
+		uint16_t packColor565(const int* color) {
+			int r = (color[0] * 31 + 127) / 255;
+			int g = (color[1] * 63 + 127) / 255;
+			int b = (color[2] * 31 + 127) / 255;
+			return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		void unpackColor565(uint16_t packed, int* color) {
+			int r = (packed >> 11) & 31;
+			int g = (packed >> 5) & 63;
+			int b = packed & 31;
+			color[0] = (r << 3) | (r >> 2);
+			color[1] = (g << 2) | (g >> 4);
+			color[2] = (b << 3) | (b >> 2);
+		}
+
+		uint32_t nearestIndex(const uint8_t* pixel, const int palette[][4], uint32_t paletteSize, uint32_t channelCount) {
+			uint32_t best = 0;
+			int bestError = INT32_MAX;
+			for (uint32_t i = 0; i < paletteSize; i++) {
+				int error = 0;
+				for (uint32_t c = 0; c < channelCount; c++) {
+					int diff = pixel[c] - palette[i][c];
+					error += diff * diff;
+				}
+				if (error < bestError) {
+					bestError = error;
+					best = i;
+				}
+			}
+			return best;
+		}
+
+		// bc7 fields are packed lsb first across the whole 16 bytes
+		class BitWriter {
+		public:
+			BitWriter(uint8_t* out) {
+				_out = out;
+				_position = 0;
+				memset(_out, 0, 16);
+			}
+
+			void write(uint32_t value, uint32_t bitCount) {
+				for (uint32_t i = 0; i < bitCount; i++) {
+					if ((value >> i) & 1) {
+						_out[_position >> 3] |= static_cast<uint8_t>(1 << (_position & 7));
+					}
+					_position++;
+				}
+			}
+
+		private:
+			uint8_t* _out;
+			uint32_t _position;
+		};
+	}
+
+	bool BlockCompressor::parseFormat(const std::string& name, CookedFormat* format) {
+		if (name == "bc1") {
+			*format = CookedFormat::Bc1;
+		}
+		else if (name == "bc3") {
+			*format = CookedFormat::Bc3;
+		}
+		else if (name == "bc4") {
+			*format = CookedFormat::Bc4;
+		}
+		else if (name == "bc5") {
+			*format = CookedFormat::Bc5;
+		}
+		else if (name == "bc7") {
+			*format = CookedFormat::Bc7;
+		}
+		else if (name == "rgba8") {
+			*format = CookedFormat::Rgba8;
+		}
+		else {
+			return false;
+		}
+		return true;
+	}
+
+	uint32_t BlockCompressor::getVkFormat(CookedFormat format) {
+		switch (format) {
+		case CookedFormat::Bc1:
+			return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+		case CookedFormat::Bc3:
+			return VK_FORMAT_BC3_UNORM_BLOCK;
+		case CookedFormat::Bc4:
+			return VK_FORMAT_BC4_UNORM_BLOCK;
+		case CookedFormat::Bc5:
+			return VK_FORMAT_BC5_UNORM_BLOCK;
+		case CookedFormat::Bc7:
+			return VK_FORMAT_BC7_UNORM_BLOCK;
+		default:
+			return VK_FORMAT_R8G8B8A8_UNORM;
+		}
+	}
+
+	uint32_t BlockCompressor::getBlockSize(CookedFormat format) {
+		switch (format) {
+		case CookedFormat::Bc1:
+		case CookedFormat::Bc4:
+			return 8;
+		case CookedFormat::Bc3:
+		case CookedFormat::Bc5:
+		case CookedFormat::Bc7:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	std::vector<char> BlockCompressor::compress(CookedFormat format, const uint8_t* pixels, uint32_t width, uint32_t height, ThreadPool* threadPool) {
+		uint32_t blockSize = getBlockSize(format);
+		if (blockSize == 0) {
+			return std::vector<char>(reinterpret_cast<const char*>(pixels), reinterpret_cast<const char*>(pixels) + static_cast<size_t>(width) * height * 4);
+		}
+
+		uint32_t blocksWide = (width + 3) / 4;
+		uint32_t blocksHigh = (height + 3) / 4;
+		std::vector<char> data(static_cast<size_t>(blocksWide) * blocksHigh * blockSize);
+
+		std::vector<std::future<void>> bands;
+		for (uint32_t firstRow = 0; firstRow < blocksHigh; firstRow += BLOCK_ROWS_PER_TASK) {
+			uint32_t lastRow = (std::min)(firstRow + BLOCK_ROWS_PER_TASK, blocksHigh);
+			uint8_t* out = reinterpret_cast<uint8_t*>(data.data());
+			bands.push_back(threadPool->enqueue([=]() {
+				uint8_t block[64];
+				for (uint32_t blockY = firstRow; blockY < lastRow; blockY++) {
+					for (uint32_t blockX = 0; blockX < blocksWide; blockX++) {
+						// blocks hanging over the edge repeat the last row and column
+						for (uint32_t y = 0; y < 4; y++) {
+							uint32_t sourceY = (std::min)(blockY * 4 + y, height - 1);
+							for (uint32_t x = 0; x < 4; x++) {
+								uint32_t sourceX = (std::min)(blockX * 4 + x, width - 1);
+								memcpy(block + (y * 4 + x) * 4, pixels + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+							}
+						}
+						compressBlock(format, block, out + (static_cast<size_t>(blockY) * blocksWide + blockX) * blockSize);
+					}
+				}
+			}));
+		}
+		for (auto& band : bands) {
+			band.get();
+		}
+		return data;
+	}
+
+	void BlockCompressor::compressBlock(CookedFormat format, const uint8_t* block, uint8_t* out) {
+		switch (format) {
+		case CookedFormat::Bc1:
+			encodeColorBlock(block, out);
+			break;
+		case CookedFormat::Bc3:
+			encodeChannelBlock(block, 3, out);
+			encodeColorBlock(block, out + 8);
+			break;
+		case CookedFormat::Bc4:
+			encodeChannelBlock(block, 0, out);
+			break;
+		case CookedFormat::Bc5:
+			encodeChannelBlock(block, 0, out);
+			encodeChannelBlock(block, 1, out + 8);
+			break;
+		case CookedFormat::Bc7:
+			encodeBc7Block(block, out);
+			break;
+		default:
+			break;
+		}
+	}
+
+	void BlockCompressor::encodeColorBlock(const uint8_t* block, uint8_t* out) {
+		int low[4];
+		int high[4];
+		fitEndpoints(block, 3, low, high);
+
+		// pull the ends in a little, the box corners are rarely hit by the block's actual colours
+		for (uint32_t c = 0; c < 3; c++) {
+			int inset = (high[c] - low[c]) / 16;
+			high[c] -= inset;
+			low[c] += inset;
+		}
+
+		uint16_t color0 = packColor565(high);
+		uint16_t color1 = packColor565(low);
+		// color0 > color1 selects the opaque four colour mode
+		if (color0 < color1) {
+			std::swap(color0, color1);
+		}
+
+		uint32_t indices = 0;
+		if (color0 != color1) {
+			int palette[4][4];
+			unpackColor565(color0, palette[0]);
+			unpackColor565(color1, palette[1]);
+			for (uint32_t c = 0; c < 3; c++) {
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			for (uint32_t i = 0; i < 16; i++) {
+				indices |= nearestIndex(block + i * 4, palette, 4, 3) << (i * 2);
+			}
+		}
+
+		memcpy(out, &color0, 2);
+		memcpy(out + 2, &color1, 2);
+		memcpy(out + 4, &indices, 4);
+	}
+
+	void BlockCompressor::encodeChannelBlock(const uint8_t* block, uint32_t channel, uint8_t* out) {
+		int low = 255;
+		int high = 0;
+		for (uint32_t i = 0; i < 16; i++) {
+			low = (std::min)(low, static_cast<int>(block[i * 4 + channel]));
+			high = (std::max)(high, static_cast<int>(block[i * 4 + channel]));
+		}
+
+		// high > low selects the eight value mode, equal ends leave every index at 0
+		uint64_t indices = 0;
+		if (high != low) {
+			int palette[8][4];
+			palette[0][0] = high;
+			palette[1][0] = low;
+			for (int i = 1; i < 7; i++) {
+				palette[i + 1][0] = ((7 - i) * high + i * low) / 7;
+			}
+			for (uint32_t i = 0; i < 16; i++) {
+				uint8_t value = block[i * 4 + channel];
+				indices |= static_cast<uint64_t>(nearestIndex(&value, palette, 8, 1)) << (i * 3);
+			}
+		}
+
+		out[0] = static_cast<uint8_t>(high);
+		out[1] = static_cast<uint8_t>(low);
+		for (uint32_t i = 0; i < 6; i++) {
+			out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+		}
+	}
+
+	void BlockCompressor::encodeBc7Block(const uint8_t* block, uint8_t* out) {
+		int endpoints[2][4];
+		fitEndpoints(block, 4, endpoints[0], endpoints[1]);
+
+		// mode 6 stores 7 bits per channel plus one shared low bit per endpoint, pick the bit that loses the least
+		int quantized[2][4];
+		int pBits[2];
+		int palette[16][4];
+		int reconstructed[2][4];
+		for (uint32_t e = 0; e < 2; e++) {
+			int bestError = INT32_MAX;
+			for (int p = 0; p < 2; p++) {
+				int error = 0;
+				int candidate[4];
+				for (uint32_t c = 0; c < 4; c++) {
+					candidate[c] = (std::min)((std::max)((endpoints[e][c] - p + 1) >> 1, 0), 127);
+					int diff = ((candidate[c] << 1) | p) - endpoints[e][c];
+					error += diff * diff;
+				}
+				if (error < bestError) {
+					bestError = error;
+					pBits[e] = p;
+					memcpy(quantized[e], candidate, sizeof(candidate));
+				}
+			}
+			for (uint32_t c = 0; c < 4; c++) {
+				reconstructed[e][c] = (quantized[e][c] << 1) | pBits[e];
+			}
+		}
+
+		for (uint32_t i = 0; i < 16; i++) {
+			for (uint32_t c = 0; c < 4; c++) {
+				palette[i][c] = ((64 - BC7_WEIGHTS[i]) * reconstructed[0][c] + BC7_WEIGHTS[i] * reconstructed[1][c] + 32) >> 6;
+			}
+		}
+
+		uint32_t indices[16];
+		for (uint32_t i = 0; i < 16; i++) {
+			indices[i] = nearestIndex(block + i * 4, palette, 16, 4);
+		}
+
+		// the first index drops its top bit, so it has to be below 8. flipping the endpoints mirrors the indices
+		if (indices[0] >= 8) {
+			for (uint32_t c = 0; c < 4; c++) {
+				std::swap(quantized[0][c], quantized[1][c]);
+			}
+			std::swap(pBits[0], pBits[1]);
+			for (uint32_t i = 0; i < 16; i++) {
+				indices[i] = 15 - indices[i];
+			}
+		}
+
+		BitWriter writer(out);
+		writer.write(1 << 6, 7);
+		for (uint32_t c = 0; c < 4; c++) {
+			writer.write(quantized[0][c], 7);
+			writer.write(quantized[1][c], 7);
+		}
+		writer.write(pBits[0], 1);
+		writer.write(pBits[1], 1);
+		writer.write(indices[0], 3);
+		for (uint32_t i = 1; i < 16; i++) {
+			writer.write(indices[i], 4);
+		}
+	}
+}
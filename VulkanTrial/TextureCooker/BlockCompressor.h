@@ -0,0 +1,43 @@
+#ifndef BlockCompressor_h_
+#define BlockCompressor_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace litter {
+	class ThreadPool;
+
+	enum class CookedFormat {
+		Bc1,
+		Bc3,
+		Bc4,
+		Bc5,
+		Bc7,
+		Rgba8
+	};
+
+	// encodes rgba8 levels into the bc formats. the encoders go for speed over quality: bc1/bc3 colour and bc7
+	// fit one line through the bounding box of each block, bc7 only ever uses mode 6
+	class BlockCompressor {
+	public:
+		// bc1, bc3, bc4, bc5, bc7 or rgba8, returns false for anything else
+		static bool parseFormat(const std::string& name, CookedFormat* format);
+		// the matching VkFormat
+		static uint32_t getVkFormat(CookedFormat format);
+
+		// bands of block rows are spread over the pool, the call returns once the whole level is encoded
+		static std::vector<char> compress(CookedFormat format, const uint8_t* pixels, uint32_t width, uint32_t height, ThreadPool* threadPool);
+
+	private:
+		// 8 or 16 bytes per 4x4 block, 0 for uncompressed formats
+		static uint32_t getBlockSize(CookedFormat format);
+		static void compressBlock(CookedFormat format, const uint8_t* block, uint8_t* out);
+
+		static void encodeColorBlock(const uint8_t* block, uint8_t* out);
+		static void encodeChannelBlock(const uint8_t* block, uint32_t channel, uint8_t* out);
+		static void encodeBc7Block(const uint8_t* block, uint8_t* out);
+	};
+}
+
+#endif // !BlockCompressor_h_
@@ -0,0 +1,94 @@
+#include "BlockCompressor.h"
+#include "File/TextureFile.h"
+#include "Thread/ThreadPool.h"
+#include "StdC.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+using namespace litter;
+
+namespace {
+	void printUsage() {
+		std::cerr << "usage: TextureCooker [--format bc1|bc3|bc4|bc5|bc7|rgba8] [--threads n] <image>..." << std::endl;
+		std::cerr << "writes <image without extension>.ktx2 next to every source image, with a full mip chain" << std::endl;
+	}
+
+	bool cook(const std::string& path, CookedFormat format, ThreadPool* threadPool) {
+		int width;
+		int height;
+		int channels;
+		stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (!pixels) {
+			std::cerr << "failed to load " << path << ": " << stbi_failure_reason() << std::endl;
+			return false;
+		}
+
+		TextureFileData texture;
+		texture.format = BlockCompressor::getVkFormat(format);
+		texture.width = static_cast<uint32_t>(width);
+		texture.height = static_cast<uint32_t>(height);
+
+		// the levels are filtered from the uncompressed level above, never from an already encoded one
+		std::vector<uint8_t> level(pixels, pixels + static_cast<size_t>(width) * height * 4);
+		stbi_image_free(pixels);
+
+		uint32_t levelWidth = texture.width;
+		uint32_t levelHeight = texture.height;
+		while (true) {
+			texture.levels.push_back(BlockCompressor::compress(format, level.data(), levelWidth, levelHeight, threadPool));
+			if (levelWidth == 1 && levelHeight == 1) {
+				break;
+			}
+
+			uint32_t nextWidth = (std::max)(levelWidth / 2, 1u);
+			uint32_t nextHeight = (std::max)(levelHeight / 2, 1u);
+			std::vector<uint8_t> next(static_cast<size_t>(nextWidth) * nextHeight * 4);
+			TextureFile::downsample(level.data(), levelWidth, levelHeight, next.data());
+			level.swap(next);
+			levelWidth = nextWidth;
+			levelHeight = nextHeight;
+		}
+
+		std::string cookedPath = TextureFile::getCookedPath(path);
+		if (!TextureFile::write(cookedPath, texture)) {
+			std::cerr << "failed to write " << cookedPath << std::endl;
+			return false;
+		}
+		std::cout << path << " -> " << cookedPath << " (" << texture.levels.size() << " levels)" << std::endl;
+		return true;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	CookedFormat format = CookedFormat::Bc7;
+	uint32_t threadCount = std::thread::hardware_concurrency();
+	std::vector<std::string> paths;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			if (!BlockCompressor::parseFormat(argv[++i], &format)) {
+				printUsage();
+				return EXIT_FAILURE;
+			}
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			threadCount = static_cast<uint32_t>(atoi(argv[++i]));
+		}
+		else {
+			paths.push_back(argv[i]);
+		}
+	}
+
+	if (paths.empty()) {
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	ThreadPool threadPool(threadCount);
+	bool succeeded = true;
+	for (const auto& path : paths) {
+		succeeded = cook(path, format, &threadPool) && succeeded;
+	}
+	return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,107 @@
+#include "SkylinePacker.h"
+#include "StdC.h"
+
+namespace litter {
+	SkylinePacker::SkylinePacker(uint32_t width, uint32_t height) {
+		_width = width;
+		_height = height;
+		reset();
+	}
+
+	bool SkylinePacker::insert(uint32_t width, uint32_t height, uint32_t* x, uint32_t* y) {
+		size_t bestIndex = _skyline.size();
+		uint32_t bestTop = UINT32_MAX;
+		uint32_t bestWidth = UINT32_MAX;
+		uint32_t bestY = 0;
+
+		// lowest top edge wins, the narrower segment breaks ties so wide gaps stay open for wide rects
+		for (size_t i = 0; i < _skyline.size(); i++) {
+			uint32_t candidateY;
+			if (!fits(i, width, height, &candidateY)) {
+				continue;
+			}
+			uint32_t top = candidateY + height;
+			if (top < bestTop || (top == bestTop && _skyline[i].width < bestWidth)) {
+				bestIndex = i;
+				bestTop = top;
+				bestWidth = _skyline[i].width;
+				bestY = candidateY;
+			}
+		}
+
+		if (bestIndex == _skyline.size()) {
+			return false;
+		}
+
+		Segment segment;
+		segment.x = _skyline[bestIndex].x;
+		segment.y = bestY + height;
+		segment.width = width;
+		_skyline.insert(_skyline.begin() + bestIndex, segment);
+
+		// the new segment covers the start of the ones after it, trim or drop them
+		uint32_t right = segment.x + segment.width;
+		size_t next = bestIndex + 1;
+		while (next < _skyline.size() && _skyline[next].x < right) {
+			uint32_t segmentRight = _skyline[next].x + _skyline[next].width;
+			if (segmentRight <= right) {
+				_skyline.erase(_skyline.begin() + next);
+				continue;
+			}
+			_skyline[next].width = segmentRight - right;
+			_skyline[next].x = right;
+			break;
+		}
+
+		// neighbours at the same height become one segment
+		for (size_t i = 0; i + 1 < _skyline.size();) {
+			if (_skyline[i].y == _skyline[i + 1].y) {
+				_skyline[i].width += _skyline[i + 1].width;
+				_skyline.erase(_skyline.begin() + i + 1);
+			}
+			else {
+				i++;
+			}
+		}
+
+		*x = segment.x;
+		*y = bestY;
+		_usedArea += static_cast<uint64_t>(width) * height;
+		return true;
+	}
+
+	void SkylinePacker::reset() {
+		Segment segment;
+		segment.x = 0;
+		segment.y = 0;
+		segment.width = _width;
+
+		_skyline.clear();
+		_skyline.push_back(segment);
+		_usedArea = 0;
+	}
+
+	float SkylinePacker::getOccupancy() {
+		return static_cast<float>(static_cast<double>(_usedArea) / (static_cast<double>(_width) * _height));
+	}
+
+	bool SkylinePacker::fits(size_t index, uint32_t width, uint32_t height, uint32_t* y) {
+		if (_skyline[index].x + width > _width) {
+			return false;
+		}
+
+		// the rect rests on the highest segment it spans
+		uint32_t top = 0;
+		uint32_t remaining = width;
+		for (size_t i = index; remaining > 0; i++) {
+			top = (std::max)(top, _skyline[i].y);
+			if (top + height > _height) {
+				return false;
+			}
+			remaining -= (std::min)(remaining, _skyline[i].width);
+		}
+
+		*y = top;
+		return true;
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef SkylinePacker_h_
+#define SkylinePacker_h_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace litter {
+	// bottom-left skyline rectangle packer. the free space above the packed rects is kept as a list of horizontal
+	// segments, every rect goes where its top edge ends up lowest. nothing is ever freed, reset starts over
+	class SkylinePacker {
+	public:
+		SkylinePacker(uint32_t width, uint32_t height);
+
+		// false, with nothing changed, when the rect doesn't fit anywhere
+		bool insert(uint32_t width, uint32_t height, uint32_t* x, uint32_t* y);
+		void reset();
+		// fraction of the area covered by packed rects
+		float getOccupancy();
+
+	private:
+		struct Segment {
+			uint32_t x;
+			uint32_t y;
+			uint32_t width;
+		};
+
+		// the height a rect starting at segment index would be placed at, false when it runs off the edge
+		bool fits(size_t index, uint32_t width, uint32_t height, uint32_t* y);
+
+	private:
+		uint32_t _width;
+		uint32_t _height;
+		uint64_t _usedArea;
+		std::vector<Segment> _skyline;
+	};
+}
+
+#endif // !SkylinePacker_h_
@@ -0,0 +1,16 @@
+#include "Hash.h"
+
+namespace litter {
+	namespace {
+		const uint64_t FNV_PRIME = 1099511628211ull;
+	}
+
+	uint64_t Hash::fnv1a(uint64_t hash, const void* data, size_t size) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+}
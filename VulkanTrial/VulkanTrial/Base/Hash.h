@@ -0,0 +1,18 @@
+#ifndef Hash_h_
+#define Hash_h_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace litter {
+	// 64 bit fnv-1a, fast and good enough for cache keys
+	class Hash {
+	public:
+		static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+		// folds the bytes into a running hash, start from FNV_OFFSET_BASIS
+		static uint64_t fnv1a(uint64_t hash, const void* data, size_t size);
+	};
+}
+
+#endif // !Hash_h_
@@ -1,5 +1,13 @@
 #include "File.h"
 #include "StdC.h"
+#include <cstdio>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
 
 namespace litter {
 	std::vector<char> File::readFile(const std::string& filename)
@@ -20,4 +28,47 @@ namespace litter {
 
 		return buffer;
 	}
+
+	bool File::writeFile(const std::string& filename, const std::vector<char>& data)
+	{
+		std::string tempFilename = filename + ".tmp";
+
+		std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			return false;
+		}
+
+		file.write(data.data(), data.size());
+		file.close();
+		if (file.fail()) {
+			std::remove(tempFilename.c_str());
+			return false;
+		}
+
+#ifdef _WIN32
+		// std::rename refuses to replace an existing file on windows
+		bool renamed = MoveFileExA(tempFilename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		bool renamed = std::rename(tempFilename.c_str(), filename.c_str()) == 0;
+#endif
+		if (!renamed) {
+			std::remove(tempFilename.c_str());
+		}
+		return renamed;
+	}
+
+	bool File::exists(const std::string& filename)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		return file.is_open();
+	}
+
+	bool File::createDirectory(const std::string& path)
+	{
+#ifdef _WIN32
+		return CreateDirectoryA(path.c_str(), nullptr) != 0 || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+		return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+	}
 }
@@ -1,12 +1,18 @@
 #ifndef File_h_
 #define File_h_
 
+#include <string>
 #include <vector>
 
 namespace litter {
 	class File {
 	public:
 		static std::vector<char> readFile(const std::string& filename);
+		// writes next to the target and renames over it, readers never see a partial file
+		static bool writeFile(const std::string& filename, const std::vector<char>& data);
+		static bool exists(const std::string& filename);
+		// creates a single directory level, succeeds if it already exists
+		static bool createDirectory(const std::string& path);
 	};
 }
 
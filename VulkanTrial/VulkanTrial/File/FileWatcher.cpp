@@ -0,0 +1,98 @@
+#include "FileWatcher.h"
+#include "StdC.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+namespace litter {
+	FileWatcher::FileWatcher() {
+#ifdef __linux__
+		_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (_inotifyFd < 0) {
+			throw std::runtime_error("failed to initialize inotify!");
+		}
+#endif
+	}
+
+	FileWatcher::~FileWatcher() {
+#ifdef __linux__
+		close(_inotifyFd);
+#endif
+	}
+
+	void FileWatcher::watch(const std::string& path) {
+		if (!_paths.insert(path).second) {
+			return;
+		}
+
+#ifdef __linux__
+		std::string directory = getDirectory(path);
+		// adding the same directory again returns its existing descriptor
+		int wd = inotify_add_watch(_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (wd < 0) {
+			std::cout << "failed to watch " << directory << "." << std::endl;
+			return;
+		}
+		_directories[wd] = directory;
+#else
+		_modifiedTimes[path] = getModifiedTime(path);
+#endif
+	}
+
+	void FileWatcher::poll(std::vector<std::string>* changedPaths) {
+		std::set<std::string> changed;
+
+#ifdef __linux__
+		alignas(inotify_event) char buffer[4096];
+		for (;;) {
+			ssize_t length = read(_inotifyFd, buffer, sizeof(buffer));
+			if (length <= 0) {
+				break;
+			}
+
+			for (char* ptr = buffer; ptr < buffer + length; ) {
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+				ptr += sizeof(inotify_event) + event->len;
+
+				auto directory = _directories.find(event->wd);
+				if (directory == _directories.end() || event->len == 0) {
+					continue;
+				}
+
+				std::string path = directory->second == "." ? event->name : directory->second + "/" + event->name;
+				if (_paths.count(path) > 0) {
+					changed.insert(path);
+				}
+			}
+		}
+#else
+		for (auto& entry : _modifiedTimes) {
+			long long modifiedTime = getModifiedTime(entry.first);
+			if (modifiedTime != entry.second) {
+				entry.second = modifiedTime;
+				changed.insert(entry.first);
+			}
+		}
+#endif
+
+		changedPaths->assign(changed.begin(), changed.end());
+	}
+
+	std::string FileWatcher::getDirectory(const std::string& path) {
+		size_t slash = path.find_last_of("/\\");
+		return slash == std::string::npos ? "." : path.substr(0, slash);
+	}
+
+	long long FileWatcher::getModifiedTime(const std::string& path) {
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0) {
+			return 0;
+		}
+		return static_cast<long long>(info.st_mtime);
+	}
+}
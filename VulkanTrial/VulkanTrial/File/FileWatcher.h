@@ -0,0 +1,38 @@
+#ifndef FileWatcher_h_
+#define FileWatcher_h_
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace litter {
+	// reports files that were rewritten since the last poll. on linux this is backed by inotify on the
+	// containing directories, which also catches editors that save through a rename. elsewhere it falls
+	// back to comparing modification times on every poll
+	class FileWatcher {
+	public:
+		FileWatcher();
+		~FileWatcher();
+
+		void watch(const std::string& path);
+		// never blocks, every changed path is reported once
+		void poll(std::vector<std::string>* changedPaths);
+
+	private:
+		static std::string getDirectory(const std::string& path);
+		static long long getModifiedTime(const std::string& path);
+
+	private:
+		std::set<std::string> _paths;
+#ifdef __linux__
+		int _inotifyFd;
+		// watch descriptor to directory
+		std::unordered_map<int, std::string> _directories;
+#else
+		std::unordered_map<std::string, long long> _modifiedTimes;
+#endif
+	};
+}
+
+#endif // !FileWatcher_h_
@@ -0,0 +1,102 @@
+#include "MappedFile.h"
+#include "StdC.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace litter {
+	MappedFile::MappedFile(const std::string& filename) {
+		_data = nullptr;
+		_size = 0;
+
+#ifdef _WIN32
+		_mapping = nullptr;
+		_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (_file == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error("failed to open file!");
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(_file, &size)) {
+			CloseHandle(_file);
+			throw std::runtime_error("failed to open file!");
+		}
+		_size = static_cast<size_t>(size.QuadPart);
+
+		// mapping an empty file is an error, there is nothing to map anyway
+		if (_size == 0) {
+			return;
+		}
+
+		_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (_mapping != nullptr) {
+			_data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+		if (_data == nullptr) {
+			if (_mapping != nullptr) {
+				CloseHandle(_mapping);
+			}
+			CloseHandle(_file);
+			throw std::runtime_error("failed to map file!");
+		}
+#else
+		_fd = open(filename.c_str(), O_RDONLY);
+		if (_fd < 0) {
+			throw std::runtime_error("failed to open file!");
+		}
+
+		struct stat info;
+		if (fstat(_fd, &info) != 0) {
+			close(_fd);
+			throw std::runtime_error("failed to open file!");
+		}
+		_size = static_cast<size_t>(info.st_size);
+
+		// mapping an empty file is an error, there is nothing to map anyway
+		if (_size == 0) {
+			return;
+		}
+
+		void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+		if (data == MAP_FAILED) {
+			close(_fd);
+			throw std::runtime_error("failed to map file!");
+		}
+		// parsers read front to back
+		madvise(data, _size, MADV_SEQUENTIAL);
+		_data = static_cast<const char*>(data);
+#endif
+	}
+
+	MappedFile::~MappedFile() {
+#ifdef _WIN32
+		if (_data != nullptr) {
+			UnmapViewOfFile(_data);
+		}
+		if (_mapping != nullptr) {
+			CloseHandle(_mapping);
+		}
+		CloseHandle(_file);
+#else
+		if (_data != nullptr) {
+			munmap(const_cast<char*>(_data), _size);
+		}
+		close(_fd);
+#endif
+	}
+
+	const char* MappedFile::getData() {
+		return _data;
+	}
+
+	size_t MappedFile::getSize() {
+		return _size;
+	}
+}
@@ -0,0 +1,32 @@
+#ifndef MappedFile_h_
+#define MappedFile_h_
+
+#include <cstddef>
+#include <string>
+
+namespace litter {
+	// a whole file mapped read-only into memory. pages are read in by the os as they are touched, parsers can
+	// walk the bytes in place without copying the file first. the data is not null terminated
+	class MappedFile {
+	public:
+		// throws when the file can't be opened or mapped, an empty file maps to no data
+		MappedFile(const std::string& filename);
+		~MappedFile();
+
+		const char* getData();
+		size_t getSize();
+
+	private:
+		const char* _data;
+		size_t _size;
+#ifdef _WIN32
+		// HANDLEs, windows.h stays out of the header
+		void* _file;
+		void* _mapping;
+#else
+		int _fd;
+#endif
+	};
+}
+
+#endif // !MappedFile_h_
@@ -0,0 +1,144 @@
+#include "TextureFile.h"
+#include "File.h"
+#include "StdC.h"
+
+namespace litter {
+	namespace {
+		const uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+		// identifier, nine header words and the index up to the level index
+		const size_t KTX2_HEADER_SIZE = 80;
+		const size_t KTX2_LEVEL_INDEX_ENTRY_SIZE = 24;
+		// covers every block size plus the 4 byte alignment ktx2 asks for
+		const size_t KTX2_LEVEL_ALIGNMENT = 16;
+
+		uint32_t readU32(const std::vector<char>& data, size_t offset) {
+			uint32_t value;
+			memcpy(&value, data.data() + offset, sizeof(value));
+			return value;
+		}
+
+		uint64_t readU64(const std::vector<char>& data, size_t offset) {
+			uint64_t value;
+			memcpy(&value, data.data() + offset, sizeof(value));
+			return value;
+		}
+
+		void writeU32(std::vector<char>* data, size_t offset, uint32_t value) {
+			memcpy(data->data() + offset, &value, sizeof(value));
+		}
+
+		void writeU64(std::vector<char>* data, size_t offset, uint64_t value) {
+			memcpy(data->data() + offset, &value, sizeof(value));
+		}
+	}
+
+	TextureFileData TextureFile::read(const std::string& filename) {
+		std::vector<char> data = File::readFile(filename);
+		if (data.size() < KTX2_HEADER_SIZE || memcmp(data.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+			throw std::runtime_error("failed to read texture file, not a ktx2 file!");
+		}
+
+		TextureFileData texture;
+		texture.format = readU32(data, 12);
+		texture.width = readU32(data, 20);
+		texture.height = readU32(data, 24);
+		uint32_t depth = readU32(data, 28);
+		uint32_t layerCount = readU32(data, 32);
+		uint32_t faceCount = readU32(data, 36);
+		uint32_t levelCount = readU32(data, 40);
+		uint32_t supercompressionScheme = readU32(data, 44);
+
+		if (depth > 1 || layerCount > 1 || faceCount != 1 || supercompressionScheme != 0) {
+			throw std::runtime_error("failed to read texture file, only plain 2d textures are supported!");
+		}
+		if (texture.format == 0 || texture.width == 0 || texture.height == 0) {
+			throw std::runtime_error("failed to read texture file, no format or size!");
+		}
+		// ktx2 lets zero ask for generated mips, cooked files always carry the whole chain
+		if (levelCount == 0 || data.size() < KTX2_HEADER_SIZE + static_cast<size_t>(levelCount) * KTX2_LEVEL_INDEX_ENTRY_SIZE) {
+			throw std::runtime_error("failed to read texture file, missing mip levels!");
+		}
+		uint32_t maxLevelCount = 1;
+		for (uint32_t size = (std::max)(texture.width, texture.height); size > 1; size /= 2) {
+			maxLevelCount++;
+		}
+		if (levelCount > maxLevelCount) {
+			throw std::runtime_error("failed to read texture file, more mip levels than the size allows!");
+		}
+
+		texture.levels.resize(levelCount);
+		for (uint32_t level = 0; level < levelCount; level++) {
+			size_t entry = KTX2_HEADER_SIZE + level * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+			uint64_t byteOffset = readU64(data, entry);
+			uint64_t byteLength = readU64(data, entry + 8);
+			if (byteOffset > data.size() || byteLength > data.size() - byteOffset) {
+				throw std::runtime_error("failed to read texture file, level out of bounds!");
+			}
+			texture.levels[level].assign(data.begin() + static_cast<size_t>(byteOffset),
+				data.begin() + static_cast<size_t>(byteOffset + byteLength));
+		}
+		return texture;
+	}
+
+	bool TextureFile::write(const std::string& filename, const TextureFileData& texture) {
+		uint32_t levelCount = static_cast<uint32_t>(texture.levels.size());
+
+		std::vector<char> data(KTX2_HEADER_SIZE + levelCount * KTX2_LEVEL_INDEX_ENTRY_SIZE);
+		memcpy(data.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+		writeU32(&data, 12, texture.format);
+		// typeSize, one for block compressed and byte formats alike
+		writeU32(&data, 16, 1);
+		writeU32(&data, 20, texture.width);
+		writeU32(&data, 24, texture.height);
+		writeU32(&data, 28, 0);
+		writeU32(&data, 32, 0);
+		writeU32(&data, 36, 1);
+		writeU32(&data, 40, levelCount);
+		writeU32(&data, 44, 0);
+		// dfd, kvd and sgd offsets and lengths stay zero
+
+		for (uint32_t i = 0; i < levelCount; i++) {
+			uint32_t level = levelCount - 1 - i;
+			size_t offset = (data.size() + KTX2_LEVEL_ALIGNMENT - 1) & ~(KTX2_LEVEL_ALIGNMENT - 1);
+			const std::vector<char>& levelData = texture.levels[level];
+
+			size_t entry = KTX2_HEADER_SIZE + level * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+			writeU64(&data, entry, offset);
+			writeU64(&data, entry + 8, levelData.size());
+			writeU64(&data, entry + 16, levelData.size());
+
+			data.resize(offset);
+			data.insert(data.end(), levelData.begin(), levelData.end());
+		}
+
+		return File::writeFile(filename, data);
+	}
+
+	std::string TextureFile::getCookedPath(const std::string& sourcePath) {
+		size_t extension = sourcePath.find_last_of('.');
+		if (extension == std::string::npos || sourcePath.find_first_of("/\\", extension) != std::string::npos) {
+			return sourcePath + ".ktx2";
+		}
+		return sourcePath.substr(0, extension) + ".ktx2";
+	}
+
+	void TextureFile::downsample(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst) {
+		uint32_t dstWidth = (std::max)(width / 2, 1u);
+		uint32_t dstHeight = (std::max)(height / 2, 1u);
+
+		for (uint32_t y = 0; y < dstHeight; y++) {
+			uint32_t y0 = (std::min)(y * 2, height - 1);
+			uint32_t y1 = (std::min)(y * 2 + 1, height - 1);
+			for (uint32_t x = 0; x < dstWidth; x++) {
+				uint32_t x0 = (std::min)(x * 2, width - 1);
+				uint32_t x1 = (std::min)(x * 2 + 1, width - 1);
+				for (uint32_t c = 0; c < 4; c++) {
+					uint32_t sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c] +
+						src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+					dst[(y * dstWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef TextureFile_h_
+#define TextureFile_h_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace litter {
+	struct TextureFileData {
+		// a VkFormat, kept as a plain number so the cooker doesn't need the vulkan headers for it
+		uint32_t format;
+		uint32_t width;
+		uint32_t height;
+		// level 0 is the full size image, every level is tightly packed
+		std::vector<std::vector<char>> levels;
+	};
+
+	// cooked textures in the ktx2 layout: header, level index and uncompressed level data, smallest level first.
+	// no data format descriptor or key/value data is written and both are skipped on read, the vk format is all
+	// the runtime looks at. supercompressed, array, cube and 3d textures are rejected
+	class TextureFile {
+	public:
+		// throws when the file can't be read or isn't a texture this reader handles
+		static TextureFileData read(const std::string& filename);
+		static bool write(const std::string& filename, const TextureFileData& texture);
+		// where the cooker puts the cooked version of a source image, the same path with a .ktx2 extension
+		static std::string getCookedPath(const std::string& sourcePath);
+
+		// 2x2 box filter over rgba8 pixels, odd edges are clamped. dst holds max(width / 2, 1) * max(height / 2, 1) pixels
+		static void downsample(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst);
+	};
+}
+
+#endif // !TextureFile_h_
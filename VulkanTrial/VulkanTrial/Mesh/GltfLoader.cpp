@@ -0,0 +1,491 @@
+#include "GltfLoader.h"
+#include "Json.h"
+#include "File/MappedFile.h"
+#include "Thread/ThreadPool.h"
+#include "StdC.h"
+#include <cctype>
+#include <memory>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace litter {
+	namespace {
+		const uint32_t GLB_MAGIC = 0x46546C67;
+		const uint32_t GLB_VERSION = 2;
+		const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+		const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+
+		const int COMPONENT_UNSIGNED_BYTE = 5121;
+		const int COMPONENT_UNSIGNED_SHORT = 5123;
+		const int COMPONENT_UNSIGNED_INT = 5125;
+		const int COMPONENT_FLOAT = 5126;
+
+		const int MODE_TRIANGLES = 4;
+
+		struct GltfBuffer {
+			const char* data;
+			size_t size;
+		};
+
+		// an accessor checked against its buffer, element i starts at data + i * stride
+		struct GltfAccessor {
+			const char* data;
+			size_t count;
+			size_t stride;
+			int componentType;
+			bool normalized;
+		};
+
+		struct GltfPrimitive {
+			const JsonValue* primitive;
+			glm::mat4 transform;
+		};
+
+		void throwLoadError() {
+			throw std::runtime_error("failed to load gltf!");
+		}
+
+		uint32_t readUint32(const char* p) {
+			uint32_t value;
+			memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		size_t getIndex(const JsonValue* value) {
+			double number = value != nullptr ? value->getNumber(-1.0) : -1.0;
+			if (number < 0.0) {
+				throwLoadError();
+			}
+			return static_cast<size_t>(number);
+		}
+
+		size_t getSize(const JsonValue& object, const char* key, size_t fallback) {
+			const JsonValue* value = object.find(key);
+			if (value == nullptr) {
+				return fallback;
+			}
+			return getIndex(value);
+		}
+
+		const JsonValue& getElement(const JsonValue& root, const char* array, size_t index) {
+			const JsonValue* elements = root.find(array);
+			if (elements == nullptr || index >= elements->size()) {
+				throwLoadError();
+			}
+			return (*elements)[index];
+		}
+
+		size_t getComponentSize(int componentType) {
+			switch (componentType) {
+			case COMPONENT_UNSIGNED_BYTE: return 1;
+			case COMPONENT_UNSIGNED_SHORT: return 2;
+			case COMPONENT_UNSIGNED_INT:
+			case COMPONENT_FLOAT: return 4;
+			default: return 0;
+			}
+		}
+
+		size_t getComponentCount(const std::string& type) {
+			if (type == "SCALAR") return 1;
+			if (type == "VEC2") return 2;
+			if (type == "VEC3") return 3;
+			if (type == "VEC4") return 4;
+			return 0;
+		}
+
+		std::vector<char> decodeBase64(const char* p, const char* end) {
+			std::vector<char> result;
+			result.reserve((end - p) / 4 * 3);
+
+			uint32_t bits = 0;
+			int bitCount = 0;
+			for (; p < end && *p != '='; p++) {
+				char c = *p;
+				uint32_t value;
+				if (c >= 'A' && c <= 'Z') {
+					value = static_cast<uint32_t>(c - 'A');
+				} else if (c >= 'a' && c <= 'z') {
+					value = static_cast<uint32_t>(c - 'a' + 26);
+				} else if (c >= '0' && c <= '9') {
+					value = static_cast<uint32_t>(c - '0' + 52);
+				} else if (c == '+') {
+					value = 62;
+				} else if (c == '/') {
+					value = 63;
+				} else {
+					throwLoadError();
+				}
+
+				bits = (bits << 6) | value;
+				bitCount += 6;
+				if (bitCount >= 8) {
+					bitCount -= 8;
+					result.push_back(static_cast<char>((bits >> bitCount) & 0xFF));
+				}
+			}
+			return result;
+		}
+
+		// relative uris may be percent encoded
+		std::string decodeUri(const std::string& uri) {
+			std::string result;
+			for (size_t i = 0; i < uri.size(); i++) {
+				if (uri[i] == '%' && i + 2 < uri.size() && isxdigit(static_cast<unsigned char>(uri[i + 1])) &&
+					isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+					result.push_back(static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16)));
+					i += 2;
+				} else {
+					result.push_back(uri[i]);
+				}
+			}
+			return result;
+		}
+
+		// keeps external and embedded buffers alive while the chunks are built
+		class GltfBuffers {
+		public:
+			GltfBuffers(const JsonValue& root, const std::string& path, const char* binData, size_t binSize) {
+				std::string directory;
+				size_t slash = path.find_last_of("/\\");
+				if (slash != std::string::npos) {
+					directory = path.substr(0, slash + 1);
+				}
+
+				const JsonValue* buffers = root.find("buffers");
+				size_t count = buffers != nullptr ? buffers->size() : 0;
+				_decoded.resize(count);
+
+				for (size_t i = 0; i < count; i++) {
+					const JsonValue& buffer = (*buffers)[i];
+					size_t byteLength = getSize(buffer, "byteLength", 0);
+					const JsonValue* uri = buffer.find("uri");
+
+					GltfBuffer result;
+					if (uri == nullptr) {
+						// only the first buffer of a .glb may leave out its uri, it is the binary chunk
+						if (i != 0 || binData == nullptr) {
+							throwLoadError();
+						}
+						result.data = binData;
+						result.size = binSize;
+					} else if (uri->getString().compare(0, 5, "data:") == 0) {
+						const std::string& text = uri->getString();
+						size_t comma = text.find(',');
+						if (comma == std::string::npos || text.rfind(";base64", comma) == std::string::npos) {
+							throwLoadError();
+						}
+						_decoded[i] = decodeBase64(text.data() + comma + 1, text.data() + text.size());
+						result.data = _decoded[i].data();
+						result.size = _decoded[i].size();
+					} else {
+						_files.emplace_back(new MappedFile(directory + decodeUri(uri->getString())));
+						result.data = _files.back()->getData();
+						result.size = _files.back()->getSize();
+					}
+
+					if (result.size < byteLength) {
+						throwLoadError();
+					}
+					result.size = byteLength;
+					_buffers.push_back(result);
+				}
+			}
+
+			const GltfBuffer& get(size_t index) const {
+				if (index >= _buffers.size()) {
+					throwLoadError();
+				}
+				return _buffers[index];
+			}
+
+		private:
+			std::vector<GltfBuffer> _buffers;
+			std::vector<std::vector<char>> _decoded;
+			std::vector<std::unique_ptr<MappedFile>> _files;
+		};
+
+		GltfAccessor getAccessor(const JsonValue& root, const GltfBuffers& buffers, size_t index, size_t componentCount) {
+			const JsonValue& accessor = getElement(root, "accessors", index);
+			if (accessor.find("sparse") != nullptr) {
+				throw std::runtime_error("failed to load gltf, sparse accessors are not supported!");
+			}
+
+			GltfAccessor result;
+			result.count = getSize(accessor, "count", 0);
+			result.componentType = static_cast<int>(getSize(accessor, "componentType", 0));
+			const JsonValue* normalized = accessor.find("normalized");
+			result.normalized = normalized != nullptr && normalized->getBool(false);
+
+			const JsonValue* type = accessor.find("type");
+			size_t componentSize = getComponentSize(result.componentType);
+			if (type == nullptr || getComponentCount(type->getString()) != componentCount || componentSize == 0) {
+				throwLoadError();
+			}
+			size_t elementSize = componentSize * componentCount;
+
+			// an accessor without a buffer view reads as zeros
+			if (accessor.find("bufferView") == nullptr) {
+				static const char zeros[16] = {};
+				result.data = zeros;
+				result.stride = 0;
+				return result;
+			}
+
+			const JsonValue& view = getElement(root, "bufferViews", getIndex(accessor.find("bufferView")));
+			const GltfBuffer& buffer = buffers.get(getIndex(view.find("buffer")));
+			size_t viewOffset = getSize(view, "byteOffset", 0);
+			size_t viewLength = getSize(view, "byteLength", 0);
+			size_t accessorOffset = getSize(accessor, "byteOffset", 0);
+			result.stride = getSize(view, "byteStride", elementSize);
+
+			if (viewOffset > buffer.size || viewLength > buffer.size - viewOffset || result.stride < elementSize) {
+				throwLoadError();
+			}
+			if (result.count > 0) {
+				size_t lastElement = (result.count - 1) * result.stride;
+				if (accessorOffset > viewLength || lastElement / result.stride != result.count - 1 ||
+					lastElement > viewLength - accessorOffset || elementSize > viewLength - accessorOffset - lastElement) {
+					throwLoadError();
+				}
+			}
+
+			result.data = buffer.data + viewOffset + accessorOffset;
+			return result;
+		}
+
+		float readComponent(const GltfAccessor& accessor, size_t element, size_t component) {
+			const char* p = accessor.data + element * accessor.stride;
+			switch (accessor.componentType) {
+			case COMPONENT_FLOAT: {
+				float value;
+				memcpy(&value, p + component * sizeof(float), sizeof(value));
+				return value;
+			}
+			case COMPONENT_UNSIGNED_BYTE:
+				return static_cast<uint8_t>(p[component]) / 255.0f;
+			case COMPONENT_UNSIGNED_SHORT: {
+				uint16_t value;
+				memcpy(&value, p + component * sizeof(uint16_t), sizeof(value));
+				return value / 65535.0f;
+			}
+			default:
+				throwLoadError();
+				return 0.0f;
+			}
+		}
+
+		uint32_t readIndex(const GltfAccessor& accessor, size_t element) {
+			const char* p = accessor.data + element * accessor.stride;
+			switch (accessor.componentType) {
+			case COMPONENT_UNSIGNED_BYTE:
+				return static_cast<uint8_t>(*p);
+			case COMPONENT_UNSIGNED_SHORT: {
+				uint16_t value;
+				memcpy(&value, p, sizeof(value));
+				return value;
+			}
+			case COMPONENT_UNSIGNED_INT: {
+				uint32_t value;
+				memcpy(&value, p, sizeof(value));
+				return value;
+			}
+			default:
+				throwLoadError();
+				return 0;
+			}
+		}
+
+		glm::mat4 getNodeTransform(const JsonValue& node) {
+			const JsonValue* matrix = node.find("matrix");
+			if (matrix != nullptr) {
+				if (matrix->size() != 16) {
+					throwLoadError();
+				}
+				// column major, like glm
+				glm::mat4 result;
+				for (int i = 0; i < 16; i++) {
+					result[i / 4][i % 4] = static_cast<float>((*matrix)[i].getNumber(0.0));
+				}
+				return result;
+			}
+
+			glm::vec3 translation(0.0f);
+			glm::quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
+			glm::vec3 scale(1.0f);
+
+			const JsonValue* value = node.find("translation");
+			if (value != nullptr && value->size() == 3) {
+				translation = glm::vec3((*value)[0].getNumber(0.0), (*value)[1].getNumber(0.0), (*value)[2].getNumber(0.0));
+			}
+			value = node.find("rotation");
+			if (value != nullptr && value->size() == 4) {
+				// stored as x, y, z, w
+				rotation = glm::quat(static_cast<float>((*value)[3].getNumber(1.0)), static_cast<float>((*value)[0].getNumber(0.0)),
+					static_cast<float>((*value)[1].getNumber(0.0)), static_cast<float>((*value)[2].getNumber(0.0)));
+			}
+			value = node.find("scale");
+			if (value != nullptr && value->size() == 3) {
+				scale = glm::vec3((*value)[0].getNumber(1.0), (*value)[1].getNumber(1.0), (*value)[2].getNumber(1.0));
+			}
+
+			return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+		}
+
+		void collectNode(const JsonValue& root, size_t nodeIndex, const glm::mat4& parentTransform, size_t depth,
+			std::vector<GltfPrimitive>* primitives) {
+			const JsonValue* nodes = root.find("nodes");
+			// a well formed hierarchy is never deeper than its node count, anything else has a cycle
+			if (nodes == nullptr || nodeIndex >= nodes->size() || depth > nodes->size()) {
+				throwLoadError();
+			}
+
+			const JsonValue& node = (*nodes)[nodeIndex];
+			glm::mat4 transform = parentTransform * getNodeTransform(node);
+
+			const JsonValue* mesh = node.find("mesh");
+			if (mesh != nullptr) {
+				const JsonValue* meshPrimitives = getElement(root, "meshes", getIndex(mesh)).find("primitives");
+				size_t count = meshPrimitives != nullptr ? meshPrimitives->size() : 0;
+				for (size_t i = 0; i < count; i++) {
+					GltfPrimitive primitive;
+					primitive.primitive = &(*meshPrimitives)[i];
+					primitive.transform = transform;
+					primitives->push_back(primitive);
+				}
+			}
+
+			const JsonValue* children = node.find("children");
+			size_t childCount = children != nullptr ? children->size() : 0;
+			for (size_t i = 0; i < childCount; i++) {
+				collectNode(root, getIndex(&(*children)[i]), transform, depth + 1, primitives);
+			}
+		}
+
+		void buildChunk(const JsonValue& root, const GltfBuffers& buffers, const GltfPrimitive& primitive, MeshChunk* chunk) {
+			const JsonValue& object = *primitive.primitive;
+			if (getSize(object, "mode", MODE_TRIANGLES) != MODE_TRIANGLES) {
+				return;
+			}
+
+			const JsonValue* attributes = object.find("attributes");
+			const JsonValue* position = attributes != nullptr ? attributes->find("POSITION") : nullptr;
+			if (position == nullptr) {
+				return;
+			}
+
+			GltfAccessor positions = getAccessor(root, buffers, getIndex(position), 3);
+			if (positions.componentType != COMPONENT_FLOAT) {
+				throwLoadError();
+			}
+
+			chunk->vertices.resize(positions.count);
+			for (size_t i = 0; i < positions.count; i++) {
+				glm::vec4 point(readComponent(positions, i, 0), readComponent(positions, i, 1), readComponent(positions, i, 2), 1.0f);
+				chunk->vertices[i].position = glm::vec3(primitive.transform * point);
+				chunk->vertices[i].texCoord = glm::vec2(0.0f);
+			}
+
+			const JsonValue* texCoord = attributes->find("TEXCOORD_0");
+			if (texCoord != nullptr) {
+				GltfAccessor texCoords = getAccessor(root, buffers, getIndex(texCoord), 2);
+				if (texCoords.count != positions.count ||
+					(texCoords.componentType != COMPONENT_FLOAT && !texCoords.normalized)) {
+					throwLoadError();
+				}
+				// gltf already puts the origin top left, same as vulkan
+				for (size_t i = 0; i < texCoords.count; i++) {
+					chunk->vertices[i].texCoord = glm::vec2(readComponent(texCoords, i, 0), readComponent(texCoords, i, 1));
+				}
+			}
+
+			const JsonValue* indices = object.find("indices");
+			if (indices != nullptr) {
+				GltfAccessor indexAccessor = getAccessor(root, buffers, getIndex(indices), 1);
+				size_t count = indexAccessor.count - indexAccessor.count % 3;
+				chunk->indices.resize(count);
+				for (size_t i = 0; i < count; i++) {
+					chunk->indices[i] = readIndex(indexAccessor, i);
+				}
+			} else {
+				size_t count = positions.count - positions.count % 3;
+				chunk->indices.resize(count);
+				for (size_t i = 0; i < count; i++) {
+					chunk->indices[i] = static_cast<uint32_t>(i);
+				}
+			}
+		}
+	}
+
+	std::vector<MeshChunk> GltfLoader::load(const std::string& path, const char* data, size_t size, ThreadPool* threadPool) {
+		const char* json = data;
+		size_t jsonSize = size;
+		const char* binData = nullptr;
+		size_t binSize = 0;
+
+		if (size >= 12 && readUint32(data) == GLB_MAGIC) {
+			if (readUint32(data + 4) != GLB_VERSION) {
+				throw std::runtime_error("failed to load gltf, unsupported version!");
+			}
+			size_t length = (std::min)(static_cast<size_t>(readUint32(data + 8)), size);
+
+			json = nullptr;
+			size_t offset = 12;
+			while (offset + 8 <= length) {
+				size_t chunkLength = readUint32(data + offset);
+				uint32_t chunkType = readUint32(data + offset + 4);
+				offset += 8;
+				if (chunkLength > length - offset) {
+					throwLoadError();
+				}
+
+				if (chunkType == GLB_CHUNK_JSON && json == nullptr) {
+					json = data + offset;
+					jsonSize = chunkLength;
+				} else if (chunkType == GLB_CHUNK_BIN && binData == nullptr) {
+					binData = data + offset;
+					binSize = chunkLength;
+				}
+				// chunks are padded to four bytes
+				offset += (chunkLength + 3) & ~static_cast<size_t>(3);
+			}
+			if (json == nullptr) {
+				throwLoadError();
+			}
+		}
+
+		JsonValue root = JsonValue::parse(json, jsonSize);
+		GltfBuffers buffers(root, path, binData, binSize);
+
+		std::vector<GltfPrimitive> primitives;
+		const JsonValue* scenes = root.find("scenes");
+		if (scenes != nullptr && scenes->size() > 0) {
+			const JsonValue& scene = getElement(root, "scenes", getSize(root, "scene", 0));
+			const JsonValue* nodes = scene.find("nodes");
+			size_t count = nodes != nullptr ? nodes->size() : 0;
+			for (size_t i = 0; i < count; i++) {
+				collectNode(root, getIndex(&(*nodes)[i]), glm::mat4(1.0f), 0, &primitives);
+			}
+		} else {
+			// no scene to place them, every mesh is taken as is
+			const JsonValue* meshes = root.find("meshes");
+			size_t count = meshes != nullptr ? meshes->size() : 0;
+			for (size_t i = 0; i < count; i++) {
+				const JsonValue* meshPrimitives = (*meshes)[i].find("primitives");
+				size_t primitiveCount = meshPrimitives != nullptr ? meshPrimitives->size() : 0;
+				for (size_t j = 0; j < primitiveCount; j++) {
+					GltfPrimitive primitive;
+					primitive.primitive = &(*meshPrimitives)[j];
+					primitive.transform = glm::mat4(1.0f);
+					primitives.push_back(primitive);
+				}
+			}
+		}
+
+		std::vector<MeshChunk> chunks(primitives.size());
+		MeshLoader::parallelFor(primitives.size(), threadPool, [&root, &buffers, &primitives, &chunks](size_t i) {
+			buildChunk(root, buffers, primitives[i], &chunks[i]);
+		});
+
+		return chunks;
+	}
+}
@@ -0,0 +1,22 @@
+#ifndef GltfLoader_h_
+#define GltfLoader_h_
+
+#include "MeshLoader.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace litter {
+	class ThreadPool;
+
+	// gltf 2.0, both the json form with external or embedded buffers and the binary .glb container.
+	// triangle primitives of the default scene are baked into world space, positions and TEXCOORD_0 only.
+	// materials, normals, skins and morph targets are skipped, sparse accessors are rejected
+	class GltfLoader {
+	public:
+		// path is used to find buffers stored next to the file. one chunk per primitive, see MeshLoader::merge
+		static std::vector<MeshChunk> load(const std::string& path, const char* data, size_t size, ThreadPool* threadPool);
+	};
+}
+
+#endif // !GltfLoader_h_
@@ -0,0 +1,349 @@
+#include "Json.h"
+#include "StdC.h"
+#include <cstdlib>
+
+namespace litter {
+	namespace {
+		// nesting deeper than this is rejected rather than recursed into
+		const int MAX_DEPTH = 256;
+
+		void throwParseError() {
+			throw std::runtime_error("failed to parse json!");
+		}
+
+		void appendUtf8(uint32_t codePoint, std::string* out) {
+			if (codePoint < 0x80) {
+				out->push_back(static_cast<char>(codePoint));
+			} else if (codePoint < 0x800) {
+				out->push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+				out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			} else if (codePoint < 0x10000) {
+				out->push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+				out->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			} else {
+				out->push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+				out->push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+				out->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+				out->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+			}
+		}
+	}
+
+	class JsonValue::Parser {
+	public:
+		Parser(const char* data, size_t size) {
+			_p = data;
+			_end = data + size;
+			_depth = 0;
+		}
+
+		JsonValue parseDocument() {
+			// a utf-8 byte order mark is tolerated
+			if (_end - _p >= 3 && static_cast<unsigned char>(_p[0]) == 0xEF && static_cast<unsigned char>(_p[1]) == 0xBB &&
+				static_cast<unsigned char>(_p[2]) == 0xBF) {
+				_p += 3;
+			}
+
+			JsonValue value = parseValue();
+			skipWhitespace();
+			if (_p != _end) {
+				throwParseError();
+			}
+			return value;
+		}
+
+	private:
+		void skipWhitespace() {
+			while (_p < _end && (*_p == ' ' || *_p == '\t' || *_p == '\n' || *_p == '\r')) {
+				_p++;
+			}
+		}
+
+		bool consume(const char* literal) {
+			size_t length = strlen(literal);
+			if (static_cast<size_t>(_end - _p) < length || memcmp(_p, literal, length) != 0) {
+				return false;
+			}
+			_p += length;
+			return true;
+		}
+
+		JsonValue parseValue() {
+			skipWhitespace();
+			if (_p >= _end) {
+				throwParseError();
+			}
+
+			JsonValue value;
+			switch (*_p) {
+			case '{':
+				parseObject(&value);
+				break;
+			case '[':
+				parseArray(&value);
+				break;
+			case '"':
+				value._type = Type::String;
+				parseString(&value._string);
+				break;
+			case 't':
+			case 'f':
+				value._type = Type::Bool;
+				value._bool = *_p == 't';
+				if (!consume(value._bool ? "true" : "false")) {
+					throwParseError();
+				}
+				break;
+			case 'n':
+				if (!consume("null")) {
+					throwParseError();
+				}
+				break;
+			default:
+				value._type = Type::Number;
+				value._number = parseNumber();
+				break;
+			}
+			return value;
+		}
+
+		void parseObject(JsonValue* value) {
+			if (++_depth > MAX_DEPTH) {
+				throwParseError();
+			}
+
+			value->_type = Type::Object;
+			_p++;
+			skipWhitespace();
+			if (_p < _end && *_p == '}') {
+				_p++;
+				_depth--;
+				return;
+			}
+
+			while (true) {
+				skipWhitespace();
+				if (_p >= _end || *_p != '"') {
+					throwParseError();
+				}
+
+				std::string key;
+				parseString(&key);
+				skipWhitespace();
+				if (_p >= _end || *_p != ':') {
+					throwParseError();
+				}
+				_p++;
+
+				value->_members.push_back(std::make_pair(key, parseValue()));
+
+				skipWhitespace();
+				if (_p >= _end) {
+					throwParseError();
+				}
+				if (*_p == '}') {
+					_p++;
+					break;
+				}
+				if (*_p != ',') {
+					throwParseError();
+				}
+				_p++;
+			}
+			_depth--;
+		}
+
+		void parseArray(JsonValue* value) {
+			if (++_depth > MAX_DEPTH) {
+				throwParseError();
+			}
+
+			value->_type = Type::Array;
+			_p++;
+			skipWhitespace();
+			if (_p < _end && *_p == ']') {
+				_p++;
+				_depth--;
+				return;
+			}
+
+			while (true) {
+				value->_elements.push_back(parseValue());
+
+				skipWhitespace();
+				if (_p >= _end) {
+					throwParseError();
+				}
+				if (*_p == ']') {
+					_p++;
+					break;
+				}
+				if (*_p != ',') {
+					throwParseError();
+				}
+				_p++;
+			}
+			_depth--;
+		}
+
+		uint32_t parseHex4() {
+			if (_end - _p < 4) {
+				throwParseError();
+			}
+
+			uint32_t result = 0;
+			for (int i = 0; i < 4; i++) {
+				char c = *_p++;
+				result <<= 4;
+				if (c >= '0' && c <= '9') {
+					result |= static_cast<uint32_t>(c - '0');
+				} else if (c >= 'a' && c <= 'f') {
+					result |= static_cast<uint32_t>(c - 'a' + 10);
+				} else if (c >= 'A' && c <= 'F') {
+					result |= static_cast<uint32_t>(c - 'A' + 10);
+				} else {
+					throwParseError();
+				}
+			}
+			return result;
+		}
+
+		void parseString(std::string* out) {
+			// skips the opening quote
+			_p++;
+			while (true) {
+				if (_p >= _end) {
+					throwParseError();
+				}
+
+				char c = *_p++;
+				if (c == '"') {
+					return;
+				}
+				if (c != '\\') {
+					out->push_back(c);
+					continue;
+				}
+
+				if (_p >= _end) {
+					throwParseError();
+				}
+				char escape = *_p++;
+				switch (escape) {
+				case '"': out->push_back('"'); break;
+				case '\\': out->push_back('\\'); break;
+				case '/': out->push_back('/'); break;
+				case 'b': out->push_back('\b'); break;
+				case 'f': out->push_back('\f'); break;
+				case 'n': out->push_back('\n'); break;
+				case 'r': out->push_back('\r'); break;
+				case 't': out->push_back('\t'); break;
+				case 'u': {
+					uint32_t codePoint = parseHex4();
+					// characters outside the basic plane come as a surrogate pair
+					if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+						if (!consume("\\u")) {
+							throwParseError();
+						}
+						uint32_t low = parseHex4();
+						if (low < 0xDC00 || low > 0xDFFF) {
+							throwParseError();
+						}
+						codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					}
+					appendUtf8(codePoint, out);
+					break;
+				}
+				default:
+					throwParseError();
+				}
+			}
+		}
+
+		double parseNumber() {
+			const char* start = _p;
+			if (_p < _end && *_p == '-') {
+				_p++;
+			}
+			while (_p < _end && ((*_p >= '0' && *_p <= '9') || *_p == '.' || *_p == 'e' || *_p == 'E' || *_p == '+' || *_p == '-')) {
+				_p++;
+			}
+
+			// strtod wants a terminated string, numbers are short enough to copy
+			std::string text(start, _p);
+			if (text.empty() || text == "-") {
+				throwParseError();
+			}
+
+			char* parsedEnd = nullptr;
+			double number = strtod(text.c_str(), &parsedEnd);
+			if (parsedEnd != text.c_str() + text.size()) {
+				throwParseError();
+			}
+			return number;
+		}
+
+	private:
+		const char* _p;
+		const char* _end;
+		int _depth;
+	};
+
+	JsonValue::JsonValue() {
+		_type = Type::Null;
+		_bool = false;
+		_number = 0.0;
+	}
+
+	JsonValue JsonValue::parse(const char* data, size_t size) {
+		Parser parser(data, size);
+		return parser.parseDocument();
+	}
+
+	JsonValue::Type JsonValue::getType() const {
+		return _type;
+	}
+
+	bool JsonValue::isNull() const {
+		return _type == Type::Null;
+	}
+
+	double JsonValue::getNumber(double fallback) const {
+		return _type == Type::Number ? _number : fallback;
+	}
+
+	bool JsonValue::getBool(bool fallback) const {
+		return _type == Type::Bool ? _bool : fallback;
+	}
+
+	const std::string& JsonValue::getString() const {
+		return _string;
+	}
+
+	size_t JsonValue::size() const {
+		if (_type == Type::Array) {
+			return _elements.size();
+		}
+		if (_type == Type::Object) {
+			return _members.size();
+		}
+		return 0;
+	}
+
+	const JsonValue& JsonValue::operator[](size_t index) const {
+		if (_type != Type::Array || index >= _elements.size()) {
+			throw std::runtime_error("json array index out of range!");
+		}
+		return _elements[index];
+	}
+
+	const JsonValue* JsonValue::find(const char* key) const {
+		for (const auto& member : _members) {
+			if (member.first == key) {
+				return &member.second;
+			}
+		}
+		return nullptr;
+	}
+}
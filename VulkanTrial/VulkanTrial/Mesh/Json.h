@@ -0,0 +1,54 @@
+#ifndef Json_h_
+#define Json_h_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace litter {
+	// just enough json for asset headers like gltf. the whole document is parsed into a tree up front,
+	// objects keep their members in file order and are searched linearly
+	class JsonValue {
+	public:
+		enum class Type {
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object
+		};
+
+		JsonValue();
+
+		// throws on malformed input, the data doesn't need to be null terminated
+		static JsonValue parse(const char* data, size_t size);
+
+		Type getType() const;
+		bool isNull() const;
+		// the fallback when the value has another type
+		double getNumber(double fallback) const;
+		bool getBool(bool fallback) const;
+		const std::string& getString() const;
+
+		// element count of an array or member count of an object, 0 for anything else
+		size_t size() const;
+		const JsonValue& operator[](size_t index) const;
+		// null when the member is missing or this isn't an object
+		const JsonValue* find(const char* key) const;
+
+	private:
+		class Parser;
+
+	private:
+		Type _type;
+		bool _bool;
+		double _number;
+		std::string _string;
+		std::vector<JsonValue> _elements;
+		std::vector<std::pair<std::string, JsonValue>> _members;
+	};
+}
+
+#endif // !Json_h_
@@ -0,0 +1,38 @@
+#ifndef MeshData_h_
+#define MeshData_h_
+
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace litter {
+	// laid out the way shader.vert reads it, the pipeline derives the stride from the shader's inputs
+	struct MeshVertex {
+		glm::vec3 position;
+		glm::vec2 texCoord;
+
+		bool operator==(const MeshVertex& other) const {
+			return position == other.position && texCoord == other.texCoord;
+		}
+	};
+
+	// ready to be copied into a vertex and an index buffer as is. triangle list, 32 bit indices
+	struct MeshData {
+		std::vector<MeshVertex> vertices;
+		std::vector<uint32_t> indices;
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+	};
+}
+
+namespace std {
+	template<> struct hash<litter::MeshVertex> {
+		size_t operator()(const litter::MeshVertex& vertex) const {
+			return hash<glm::vec3>()(vertex.position) ^ (hash<glm::vec2>()(vertex.texCoord) << 1);
+		}
+	};
+}
+
+#endif // !MeshData_h_
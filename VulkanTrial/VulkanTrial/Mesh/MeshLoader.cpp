@@ -0,0 +1,150 @@
+#include "MeshLoader.h"
+#include "ObjLoader.h"
+#include "GltfLoader.h"
+#include "File/MappedFile.h"
+#include "Thread/ThreadPool.h"
+#include "StdC.h"
+#include <cctype>
+
+namespace litter {
+	namespace {
+		std::string getExtension(const std::string& path) {
+			size_t dot = path.find_last_of('.');
+			size_t slash = path.find_last_of("/\\");
+			if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+				return std::string();
+			}
+
+			std::string extension = path.substr(dot + 1);
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) {
+				return static_cast<char>(tolower(static_cast<unsigned char>(c)));
+			});
+			return extension;
+		}
+	}
+
+	MeshData MeshLoader::load(const std::string& path, ThreadPool* threadPool) {
+		std::string extension = getExtension(path);
+		if (extension != "obj" && extension != "gltf" && extension != "glb") {
+			throw std::runtime_error("failed to load mesh, unknown file type!");
+		}
+
+		MappedFile file(path);
+		std::vector<MeshChunk> chunks;
+		if (extension == "obj") {
+			chunks = ObjLoader::load(file.getData(), file.getSize(), threadPool);
+		} else {
+			chunks = GltfLoader::load(path, file.getData(), file.getSize(), threadPool);
+		}
+
+		return merge(&chunks, threadPool);
+	}
+
+	MeshData MeshLoader::merge(std::vector<MeshChunk>* chunks, ThreadPool* threadPool) {
+		// within a chunk first, every worker with a map of its own. what is left is usually a fraction of the corners
+		parallelFor(chunks->size(), threadPool, [chunks](size_t i) {
+			MeshChunk& chunk = (*chunks)[i];
+
+			std::unordered_map<MeshVertex, uint32_t> uniqueVertices;
+			uniqueVertices.reserve(chunk.vertices.size());
+			std::vector<MeshVertex> vertices;
+			std::vector<uint32_t> remap(chunk.vertices.size());
+
+			for (size_t v = 0; v < chunk.vertices.size(); v++) {
+				auto inserted = uniqueVertices.insert(std::make_pair(chunk.vertices[v], static_cast<uint32_t>(vertices.size())));
+				if (inserted.second) {
+					vertices.push_back(chunk.vertices[v]);
+				}
+				remap[v] = inserted.first->second;
+			}
+
+			for (uint32_t& index : chunk.indices) {
+				if (index >= remap.size()) {
+					throw std::runtime_error("failed to load mesh, index out of range!");
+				}
+				index = remap[index];
+			}
+			chunk.vertices.swap(vertices);
+		});
+
+		// across chunks on one thread, chunk vertices map to the global index of their first occurrence
+		MeshData mesh;
+		std::unordered_map<MeshVertex, uint32_t> uniqueVertices;
+		std::vector<std::vector<uint32_t>> remaps(chunks->size());
+		std::vector<size_t> indexOffsets(chunks->size());
+		size_t indexCount = 0;
+
+		size_t chunkVertexCount = 0;
+		for (const MeshChunk& chunk : *chunks) {
+			chunkVertexCount += chunk.vertices.size();
+		}
+		uniqueVertices.reserve(chunkVertexCount);
+
+		for (size_t i = 0; i < chunks->size(); i++) {
+			MeshChunk& chunk = (*chunks)[i];
+			std::vector<uint32_t>& remap = remaps[i];
+			remap.resize(chunk.vertices.size());
+
+			for (size_t v = 0; v < chunk.vertices.size(); v++) {
+				auto inserted = uniqueVertices.insert(std::make_pair(chunk.vertices[v], static_cast<uint32_t>(mesh.vertices.size())));
+				if (inserted.second) {
+					mesh.vertices.push_back(chunk.vertices[v]);
+				}
+				remap[v] = inserted.first->second;
+			}
+
+			std::vector<MeshVertex>().swap(chunk.vertices);
+			indexOffsets[i] = indexCount;
+			indexCount += chunk.indices.size();
+		}
+
+		mesh.indices.resize(indexCount);
+		parallelFor(chunks->size(), threadPool, [chunks, &mesh, &remaps, &indexOffsets](size_t i) {
+			MeshChunk& chunk = (*chunks)[i];
+			const std::vector<uint32_t>& remap = remaps[i];
+			uint32_t* indices = mesh.indices.data() + indexOffsets[i];
+
+			for (size_t j = 0; j < chunk.indices.size(); j++) {
+				indices[j] = remap[chunk.indices[j]];
+			}
+			std::vector<uint32_t>().swap(chunk.indices);
+		});
+
+		mesh.boundsMin = glm::vec3(0.0f);
+		mesh.boundsMax = glm::vec3(0.0f);
+		if (!mesh.vertices.empty()) {
+			mesh.boundsMin = mesh.vertices[0].position;
+			mesh.boundsMax = mesh.vertices[0].position;
+			for (const MeshVertex& vertex : mesh.vertices) {
+				mesh.boundsMin = glm::min(mesh.boundsMin, vertex.position);
+				mesh.boundsMax = glm::max(mesh.boundsMax, vertex.position);
+			}
+		}
+
+		return mesh;
+	}
+
+	void MeshLoader::parallelFor(size_t count, ThreadPool* threadPool, const std::function<void(size_t)>& task) {
+		if (threadPool == nullptr || count <= 1) {
+			for (size_t i = 0; i < count; i++) {
+				task(i);
+			}
+			return;
+		}
+
+		std::vector<std::future<void>> results;
+		for (size_t i = 0; i < count; i++) {
+			results.push_back(threadPool->enqueue([&task, i]() {
+				task(i);
+			}));
+		}
+
+		// every task has to be done before anything is rethrown, they all point into the caller's state
+		for (std::future<void>& result : results) {
+			result.wait();
+		}
+		for (std::future<void>& result : results) {
+			result.get();
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#ifndef MeshLoader_h_
+#define MeshLoader_h_
+
+#include "MeshData.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace litter {
+	class ThreadPool;
+
+	// a piece of a mesh parsed on its own. its indices point into its own vertices, which may repeat
+	struct MeshChunk {
+		std::vector<MeshVertex> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	// loads .obj, .gltf and .glb files into one deduplicated vertex and index stream. files are mapped rather
+	// than read, large ones are parsed in chunks spread over the thread pool. the pool may be null, then
+	// everything runs on the calling thread. never call from one of the pool's own workers, the loader waits on them
+	class MeshLoader {
+	public:
+		// picks the format by extension, throws on anything it can't read
+		static MeshData load(const std::string& path, ThreadPool* threadPool);
+
+		// drops repeated vertices, first within each chunk in parallel and then across chunks,
+		// and concatenates the chunks in order. the chunks are emptied along the way
+		static MeshData merge(std::vector<MeshChunk>* chunks, ThreadPool* threadPool);
+
+		// task(i) for every i below count, returns once all of them have finished.
+		// the first exception thrown by a task is rethrown here
+		static void parallelFor(size_t count, ThreadPool* threadPool, const std::function<void(size_t)>& task);
+	};
+}
+
+#endif // !MeshLoader_h_
@@ -0,0 +1,372 @@
+#include "ObjLoader.h"
+#include "Thread/ThreadPool.h"
+#include "StdC.h"
+#include <cmath>
+
+namespace litter {
+	namespace {
+		// slices below this aren't worth a task of their own
+		const size_t MIN_SLICE_SIZE = 256 * 1024;
+		// more slices than workers, so a slice heavy on faces doesn't hold up the rest
+		const uint32_t SLICES_PER_THREAD = 4;
+
+		const uint8_t CORNER_POSITION_RELATIVE = 1;
+		const uint8_t CORNER_TEX_COORD_RELATIVE = 2;
+		const uint8_t CORNER_HAS_TEX_COORD = 4;
+
+		// negative obj indices count back from the last element read. a slice can't know how many came before it,
+		// so those are kept relative to the slice's own start and resolved once every slice has been counted
+		struct ObjCorner {
+			int64_t position;
+			int64_t texCoord;
+			uint8_t flags;
+		};
+
+		struct ObjSlice {
+			const char* begin;
+			const char* end;
+			std::vector<glm::vec3> positions;
+			std::vector<glm::vec2> texCoords;
+			// three per triangle
+			std::vector<ObjCorner> corners;
+			size_t positionBase;
+			size_t texCoordBase;
+		};
+
+		const double POWERS_OF_TEN[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		bool isSpace(char c) {
+			return c == ' ' || c == '\t' || c == '\r';
+		}
+
+		const char* skipSpaces(const char* p, const char* end) {
+			while (p < end && isSpace(*p)) {
+				p++;
+			}
+			return p;
+		}
+
+		// strtod needs a terminated string and looks at the locale, neither fits a mapped file
+		bool parseFloat(const char** cursor, const char* end, float* value) {
+			const char* p = *cursor;
+			bool negative = false;
+			if (p < end && (*p == '-' || *p == '+')) {
+				negative = *p == '-';
+				p++;
+			}
+
+			uint64_t mantissa = 0;
+			int exponent = 0;
+			int significantDigits = 0;
+			bool anyDigits = false;
+
+			while (p < end && *p >= '0' && *p <= '9') {
+				// digits past what fits only move the decimal point
+				if (significantDigits < 18) {
+					mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+					if (mantissa != 0) {
+						significantDigits++;
+					}
+				} else {
+					exponent++;
+				}
+				anyDigits = true;
+				p++;
+			}
+
+			if (p < end && *p == '.') {
+				p++;
+				while (p < end && *p >= '0' && *p <= '9') {
+					if (significantDigits < 18) {
+						mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+						if (mantissa != 0) {
+							significantDigits++;
+						}
+						exponent--;
+					}
+					anyDigits = true;
+					p++;
+				}
+			}
+
+			if (!anyDigits) {
+				return false;
+			}
+
+			if (p < end && (*p == 'e' || *p == 'E')) {
+				const char* exponentStart = p;
+				p++;
+				bool negativeExponent = false;
+				if (p < end && (*p == '-' || *p == '+')) {
+					negativeExponent = *p == '-';
+					p++;
+				}
+
+				if (p < end && *p >= '0' && *p <= '9') {
+					int explicitExponent = 0;
+					while (p < end && *p >= '0' && *p <= '9') {
+						if (explicitExponent < 10000) {
+							explicitExponent = explicitExponent * 10 + (*p - '0');
+						}
+						p++;
+					}
+					exponent += negativeExponent ? -explicitExponent : explicitExponent;
+				} else {
+					// not an exponent after all, leave the 'e' to whoever comes next
+					p = exponentStart;
+				}
+			}
+
+			double result = static_cast<double>(mantissa);
+			if (exponent < 0 && exponent >= -22) {
+				result /= POWERS_OF_TEN[-exponent];
+			} else if (exponent > 0 && exponent <= 22) {
+				result *= POWERS_OF_TEN[exponent];
+			} else if (exponent != 0) {
+				result *= std::pow(10.0, static_cast<double>(exponent));
+			}
+
+			*value = static_cast<float>(negative ? -result : result);
+			*cursor = p;
+			return true;
+		}
+
+		bool parseIndex(const char** cursor, const char* end, int64_t* value) {
+			const char* p = *cursor;
+			bool negative = false;
+			if (p < end && *p == '-') {
+				negative = true;
+				p++;
+			}
+
+			if (p >= end || *p < '0' || *p > '9') {
+				return false;
+			}
+
+			int64_t result = 0;
+			while (p < end && *p >= '0' && *p <= '9') {
+				if (result < INT32_MAX) {
+					result = result * 10 + (*p - '0');
+				}
+				p++;
+			}
+
+			*value = negative ? -result : result;
+			*cursor = p;
+			return true;
+		}
+
+		// 1 based from the front, or negative from the back of what has been read so far
+		bool resolveIndex(int64_t index, size_t sliceCount, int64_t* resolved, bool* relative) {
+			if (index > 0) {
+				*resolved = index - 1;
+				*relative = false;
+				return true;
+			}
+			if (index < 0) {
+				*resolved = static_cast<int64_t>(sliceCount) + index;
+				*relative = true;
+				return true;
+			}
+			return false;
+		}
+
+		void throwParseError() {
+			throw std::runtime_error("failed to load obj, malformed line!");
+		}
+
+		// one "v", "v/vt", "v//vn" or "v/vt/vn" reference
+		ObjCorner parseCorner(const char** cursor, const char* end, const ObjSlice& slice) {
+			ObjCorner corner;
+			corner.texCoord = 0;
+			corner.flags = 0;
+
+			int64_t index;
+			bool relative;
+			if (!parseIndex(cursor, end, &index) || !resolveIndex(index, slice.positions.size(), &corner.position, &relative)) {
+				throwParseError();
+			}
+			if (relative) {
+				corner.flags |= CORNER_POSITION_RELATIVE;
+			}
+
+			const char* p = *cursor;
+			if (p < end && *p == '/') {
+				p++;
+				if (p < end && *p != '/') {
+					if (!parseIndex(&p, end, &index) || !resolveIndex(index, slice.texCoords.size(), &corner.texCoord, &relative)) {
+						throwParseError();
+					}
+					corner.flags |= CORNER_HAS_TEX_COORD;
+					if (relative) {
+						corner.flags |= CORNER_TEX_COORD_RELATIVE;
+					}
+				}
+
+				// normals aren't part of the vertex, only skipped
+				if (p < end && *p == '/') {
+					p++;
+					if (!parseIndex(&p, end, &index)) {
+						throwParseError();
+					}
+				}
+			}
+
+			*cursor = p;
+			return corner;
+		}
+
+		void parseSlice(ObjSlice* slice) {
+			const char* p = slice->begin;
+			const char* end = slice->end;
+			// reused for every face, polygons are rarely more than a quad
+			std::vector<ObjCorner> polygon;
+
+			while (p < end) {
+				const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+				if (lineEnd == nullptr) {
+					lineEnd = end;
+				}
+
+				p = skipSpaces(p, lineEnd);
+				if (lineEnd - p >= 2 && p[0] == 'v' && isSpace(p[1])) {
+					glm::vec3 position;
+					p = skipSpaces(p + 2, lineEnd);
+					if (!parseFloat(&p, lineEnd, &position.x)) {
+						throwParseError();
+					}
+					p = skipSpaces(p, lineEnd);
+					if (!parseFloat(&p, lineEnd, &position.y)) {
+						throwParseError();
+					}
+					p = skipSpaces(p, lineEnd);
+					if (!parseFloat(&p, lineEnd, &position.z)) {
+						throwParseError();
+					}
+					slice->positions.push_back(position);
+				} else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && isSpace(p[2])) {
+					glm::vec2 texCoord(0.0f);
+					p = skipSpaces(p + 3, lineEnd);
+					if (!parseFloat(&p, lineEnd, &texCoord.x)) {
+						throwParseError();
+					}
+					// v is optional
+					p = skipSpaces(p, lineEnd);
+					parseFloat(&p, lineEnd, &texCoord.y);
+					slice->texCoords.push_back(texCoord);
+				} else if (lineEnd - p >= 2 && p[0] == 'f' && isSpace(p[1])) {
+					polygon.clear();
+					p = skipSpaces(p + 2, lineEnd);
+					while (p < lineEnd && *p != '#') {
+						polygon.push_back(parseCorner(&p, lineEnd, *slice));
+						p = skipSpaces(p, lineEnd);
+					}
+
+					if (polygon.size() < 3) {
+						throwParseError();
+					}
+					for (size_t i = 1; i + 1 < polygon.size(); i++) {
+						slice->corners.push_back(polygon[0]);
+						slice->corners.push_back(polygon[i]);
+						slice->corners.push_back(polygon[i + 1]);
+					}
+				}
+
+				p = lineEnd + 1;
+			}
+		}
+
+		// indices are 0 based into the whole file by now, relative ones were offset by the slice's base
+		int64_t toFileIndex(int64_t index, bool relative, size_t base, size_t count) {
+			if (relative) {
+				index += static_cast<int64_t>(base);
+			}
+			if (index < 0 || index >= static_cast<int64_t>(count)) {
+				throw std::runtime_error("failed to load obj, index out of range!");
+			}
+			return index;
+		}
+
+		void buildChunk(const ObjSlice& slice, const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>& texCoords, MeshChunk* chunk) {
+			chunk->vertices.resize(slice.corners.size());
+			chunk->indices.resize(slice.corners.size());
+
+			for (size_t i = 0; i < slice.corners.size(); i++) {
+				const ObjCorner& corner = slice.corners[i];
+				MeshVertex& vertex = chunk->vertices[i];
+
+				int64_t position = toFileIndex(corner.position, (corner.flags & CORNER_POSITION_RELATIVE) != 0, slice.positionBase, positions.size());
+				vertex.position = positions[static_cast<size_t>(position)];
+				vertex.texCoord = glm::vec2(0.0f);
+
+				if (corner.flags & CORNER_HAS_TEX_COORD) {
+					int64_t texCoord = toFileIndex(corner.texCoord, (corner.flags & CORNER_TEX_COORD_RELATIVE) != 0, slice.texCoordBase, texCoords.size());
+					const glm::vec2& uv = texCoords[static_cast<size_t>(texCoord)];
+					vertex.texCoord = glm::vec2(uv.x, 1.0f - uv.y);
+				}
+
+				chunk->indices[i] = static_cast<uint32_t>(i);
+			}
+		}
+	}
+
+	std::vector<MeshChunk> ObjLoader::load(const char* data, size_t size, ThreadPool* threadPool) {
+		// slices end on line breaks, so no line is split between two of them
+		uint32_t threadCount = threadPool != nullptr ? threadPool->getThreadCount() : 1;
+		size_t sliceCount = (std::max)(static_cast<size_t>(1), (std::min)(static_cast<size_t>(threadCount * SLICES_PER_THREAD), size / MIN_SLICE_SIZE));
+		size_t sliceSize = size / sliceCount + 1;
+
+		std::vector<ObjSlice> slices;
+		const char* end = data + size;
+		const char* p = data;
+		while (p < end) {
+			const char* sliceEnd = (std::min)(p + sliceSize, end);
+			if (sliceEnd < end) {
+				const char* lineEnd = static_cast<const char*>(memchr(sliceEnd, '\n', end - sliceEnd));
+				sliceEnd = lineEnd != nullptr ? lineEnd + 1 : end;
+			}
+
+			ObjSlice slice;
+			slice.begin = p;
+			slice.end = sliceEnd;
+			slice.positionBase = 0;
+			slice.texCoordBase = 0;
+			slices.push_back(slice);
+			p = sliceEnd;
+		}
+
+		MeshLoader::parallelFor(slices.size(), threadPool, [&slices](size_t i) {
+			parseSlice(&slices[i]);
+		});
+
+		size_t positionCount = 0;
+		size_t texCoordCount = 0;
+		for (ObjSlice& slice : slices) {
+			slice.positionBase = positionCount;
+			slice.texCoordBase = texCoordCount;
+			positionCount += slice.positions.size();
+			texCoordCount += slice.texCoords.size();
+		}
+
+		// faces may point at elements read by any earlier slice, so they are gathered into one array each
+		std::vector<glm::vec3> positions(positionCount);
+		std::vector<glm::vec2> texCoords(texCoordCount);
+		MeshLoader::parallelFor(slices.size(), threadPool, [&slices, &positions, &texCoords](size_t i) {
+			ObjSlice& slice = slices[i];
+			std::copy(slice.positions.begin(), slice.positions.end(), positions.begin() + slice.positionBase);
+			std::copy(slice.texCoords.begin(), slice.texCoords.end(), texCoords.begin() + slice.texCoordBase);
+			std::vector<glm::vec3>().swap(slice.positions);
+			std::vector<glm::vec2>().swap(slice.texCoords);
+		});
+
+		std::vector<MeshChunk> chunks(slices.size());
+		MeshLoader::parallelFor(slices.size(), threadPool, [&slices, &positions, &texCoords, &chunks](size_t i) {
+			buildChunk(slices[i], positions, texCoords, &chunks[i]);
+		});
+
+		return chunks;
+	}
+}
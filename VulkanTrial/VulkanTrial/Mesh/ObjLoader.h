@@ -0,0 +1,20 @@
+#ifndef ObjLoader_h_
+#define ObjLoader_h_
+
+#include "MeshLoader.h"
+#include <cstddef>
+#include <vector>
+
+namespace litter {
+	class ThreadPool;
+
+	// wavefront obj, positions and texture coordinates only. polygons are fanned into triangles, normals,
+	// groups and materials are skipped. texture coordinates are flipped to vulkan's top left origin
+	class ObjLoader {
+	public:
+		// one chunk per slice of the file, in file order. see MeshLoader::merge
+		static std::vector<MeshChunk> load(const char* data, size_t size, ThreadPool* threadPool);
+	};
+}
+
+#endif // !ObjLoader_h_
@@ -1,8 +1,8 @@
 #ifndef RENDERER_H_
 #define RENDERER_H_
 
-#include "VulkanUtils\VulkanHeader.h"
-#include <glm\glm.hpp>
+#include "VulkanUtils/VulkanHeader.h"
+#include <glm/glm.hpp>
 
 class Renderer
 {
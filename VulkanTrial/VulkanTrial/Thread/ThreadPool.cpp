@@ -0,0 +1,51 @@
+#include "ThreadPool.h"
+
+namespace litter {
+	ThreadPool::ThreadPool(uint32_t threadCount) {
+		_stopping = false;
+
+		if (threadCount == 0) {
+			threadCount = 1;
+		}
+
+		for (uint32_t i = 0; i < threadCount; i++) {
+			_workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+		_condition.notify_all();
+
+		for (auto& worker : _workers) {
+			worker.join();
+		}
+	}
+
+	uint32_t ThreadPool::getThreadCount() {
+		return static_cast<uint32_t>(_workers.size());
+	}
+
+	void ThreadPool::workerLoop() {
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_condition.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+
+				// drain whatever is queued before shutting down so no future is left without a value
+				if (_stopping && _tasks.empty()) {
+					return;
+				}
+
+				task = std::move(_tasks.front());
+				_tasks.pop();
+			}
+
+			task();
+		}
+	}
+}
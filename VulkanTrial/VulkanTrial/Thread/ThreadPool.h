@@ -0,0 +1,52 @@
+#ifndef ThreadPool_h_
+#define ThreadPool_h_
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace litter {
+	class ThreadPool {
+	public:
+		ThreadPool(uint32_t threadCount);
+		~ThreadPool();
+
+		uint32_t getThreadCount();
+
+		// exceptions thrown by the task are rethrown from the returned future's get()
+		template<class F>
+		std::future<typename std::result_of<F()>::type> enqueue(F&& task);
+
+	private:
+		void workerLoop();
+
+	private:
+		std::vector<std::thread> _workers;
+		std::queue<std::function<void()>> _tasks;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		bool _stopping;
+	};
+
+	template<class F>
+	std::future<typename std::result_of<F()>::type> ThreadPool::enqueue(F&& task) {
+		typedef typename std::result_of<F()>::type ResultType;
+
+		auto packagedTask = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(task));
+		std::future<ResultType> result = packagedTask->get_future();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_tasks.push([packagedTask]() { (*packagedTask)(); });
+		}
+		_condition.notify_one();
+
+		return result;
+	}
+}
+
+#endif // !ThreadPool_h_
@@ -7,33 +7,26 @@
 namespace litter {
 	class VulkanPhysicalDevice;
 	class VulkanLogicalDevice;
-	class VulkanCommandPool;
+	class VulkanUploadManager;
+	class VulkanMesh;
 
 	class TextureRenderCmd {
 	public:
-		TextureRenderCmd(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanCommandPool* commandPool);
+		TextureRenderCmd(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanUploadManager* uploadManager);
 		~TextureRenderCmd();
 
 		vk::Buffer* getVertexBuffer();
 		vk::Buffer* getIndexBuffer();
 		size_t getIndexSize();
 	private:
-		void createVertexBuffer();
-		void createIndexBuffer();
-		void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer& buffer, vk::DeviceMemory& bufferMemory);
-		void copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size);
-		uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
+		void createMesh();
 
 	private:
-		size_t _indexSize;
-		vk::Buffer _vertexBuffer;
-		vk::Buffer _indexBuffer;
-		vk::DeviceMemory _vertexBufferMemory;
-		vk::DeviceMemory _indexBufferMemory;
+		VulkanMesh* _mesh;
 
 		VulkanPhysicalDevice* _physicalDevice;
 		VulkanLogicalDevice* _logicalDevice;
-		VulkanCommandPool* _commandPool;
+		VulkanUploadManager* _uploadManager;
 	};
 }
 
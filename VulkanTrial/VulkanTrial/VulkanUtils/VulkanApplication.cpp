@@ -24,9 +24,21 @@ void DestroyDebugReportCallbackEXT(vk::Instance instance, vk::DebugReportCallbac
 	}
 }
 
-VulkanApplication::VulkanApplication()
-	: _windowWidth(0)
+VulkanApplication::VulkanApplication(uint32_t framesInFlight)
+	: _window(nullptr)
+	, _windowWidth(0)
 	, _windowHeight(0)
+	, _framesInFlight(framesInFlight)
+	, _headless(false)
+	, _frameLimit(0)
+	, _textureSlot(0)
+	, _mesh(nullptr)
+	, _cameraUniformOffset(0)
+	, _profiler(nullptr)
+	, _fileWatcher(nullptr)
+	, _renderPassGeneration(0)
+	, _pipelineReloadGeneration(0)
+	, _pipelineReloadQueued(false)
 {
 }
 
@@ -34,9 +46,27 @@ VulkanApplication::~VulkanApplication()
 {
 }
 
+void VulkanApplication::setHeadless(uint32_t width, uint32_t height, uint32_t frameLimit)
+{
+	_headless = true;
+	_windowWidth = width;
+	_windowHeight = height;
+	_frameLimit = frameLimit;
+}
+
+void VulkanApplication::setProfileOutput(const std::string& path)
+{
+	_profileOutput = path;
+}
+
+void VulkanApplication::setMeshPath(const std::string& path)
+{
+	_meshPath = path;
+}
+
 bool VulkanApplication::init()
 {
-	if (initWindow() && initVulkan())
+	if ((_headless || initWindow()) && initVulkan())
 	{
 		return true;
 	}
@@ -45,29 +75,63 @@ bool VulkanApplication::init()
 
 void VulkanApplication::run()
 {
-	mainLoop();
+	if (_headless)
+	{
+		benchmarkLoop();
+	}
+	else
+	{
+		mainLoop();
+	}
 }
 
 void VulkanApplication::cleanup()
 {
+	if (_pipelineReload.valid())
+	{
+		try
+		{
+			delete _pipelineReload.get();
+		}
+		catch (const std::runtime_error&)
+		{
+		}
+	}
+	delete _fileWatcher;
+
 	delete _depthResource;
 	delete _framebufferPool;
 	delete _commandBuffers;
+	delete _drawList;
+	delete _parallelRecorder;
+	delete _threadPool;
+	delete _pipeline;
 	delete _renderPass;
 	delete _swapChain;
 	delete _imageViewPool;
 
-	vk::Device* device = _logicalDevice->getObject();
-
-	device->destroyDescriptorPool(_descriptorPool, nullptr);
-	delete _descriptorSetLayout;
+	delete _descriptorSetCache;
+	delete _descriptorAllocator;
+	delete _textureTable;
+	delete _descriptorSetLayoutCache;
+	delete _shaderManager;
 
 	delete _camera;
+	delete _uniformRing;
 
+	delete _textureLoader;
+	delete _mesh;
 	delete _textureRenderCmd;
+	delete _uploadManager;
+
+	if (_profiler != nullptr)
+	{
+		_profiler->writeChromeTrace(_profileOutput);
+		_logicalDevice->setProfiler(nullptr);
+		delete _profiler;
+	}
 
-	device->destroySemaphore(_renderFinishedSemaphore, nullptr);
-	device->destroySemaphore(_imageAvailableSemaphore, nullptr);
+	delete _framePool;
 
 	delete _commandPool;
 
@@ -77,7 +141,10 @@ void VulkanApplication::cleanup()
 	DestroyDebugReportCallbackEXT(*vkInstance, _callback, nullptr);
 	delete _surface;
 
-	SDL_DestroyWindow(_window);
+	if (_window != nullptr)
+	{
+		SDL_DestroyWindow(_window);
+	}
 	SDL_Quit();
 
 	delete _instance;
@@ -125,6 +192,16 @@ void VulkanApplication::mainLoop()
 			}
 		}
 
+		litter::ProfileZone zone(_profiler, "mainLoop");
+
+		_framePool->waitCurrentFrame();
+		if (_profiler != nullptr)
+		{
+			_profiler->beginFrame(_framePool->getCurrentIndex());
+		}
+		_descriptorSetCache->beginFrame();
+		reloadChangedPipelines();
+		_textureLoader->update();
 		updateUniformBuffer(offsetX);
 		drawFrame();
 		SDL_Delay(10);
@@ -133,19 +210,59 @@ void VulkanApplication::mainLoop()
 	_logicalDevice->getObject()->waitIdle();
 }
 
+void VulkanApplication::benchmarkLoop()
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	for (uint32_t frame = 0; frame < _frameLimit; frame++)
+	{
+		litter::ProfileZone zone(_profiler, "mainLoop");
+
+		_framePool->waitCurrentFrame();
+		if (_profiler != nullptr)
+		{
+			_profiler->beginFrame(_framePool->getCurrentIndex());
+		}
+		_descriptorSetCache->beginFrame();
+		_textureLoader->update();
+		updateUniformBuffer(0.0f);
+		drawFrame();
+	}
+
+	_logicalDevice->getObject()->waitIdle();
+
+	auto endTime = std::chrono::high_resolution_clock::now();
+	double seconds = std::chrono::duration<double>(endTime - startTime).count();
+	if (_frameLimit > 0 && seconds > 0.0)
+	{
+		std::cout << "frames: " << _frameLimit
+			<< " total: " << seconds << "s"
+			<< " frame time: " << (seconds * 1000.0 / _frameLimit) << "ms"
+			<< " fps: " << (_frameLimit / seconds) << std::endl;
+	}
+}
+
 void VulkanApplication::updateUniformBuffer(float offsetX)
 {
+	litter::ProfileZone zone(_profiler, "updateUniformBuffer");
+
 	static auto startTime = std::chrono::high_resolution_clock::now();
 	auto currentTime = std::chrono::high_resolution_clock::now();
 	float time = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - startTime).count() / 1000.0f;
 
 	_camera->setSize(_swapChain->getExtentWidth(), _swapChain->getExtentHeight());
-	_camera->update(offsetX * time);
+	_uniformRing->beginFrame(_framePool->getCurrentIndex());
+	_cameraUniformOffset = _camera->update(offsetX * time, _uniformRing);
 }
 
 void VulkanApplication::drawFrame() {
+	litter::ProfileZone zone(_profiler, "drawFrame");
+
+	uint32_t frameIndex = _framePool->getCurrentIndex();
+	litter::VulkanFrame* frame = _framePool->getCurrentFrame();
+
 	uint32_t imageIndex;
-	vk::Result result = _logicalDevice->getObject()->acquireNextImageKHR(*_swapChain->getObject(), _ULLONG_MAX, _imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+	vk::Result result = _swapChain->acquireNextImage(frame->imageAvailableSemaphore, &imageIndex);
 	if (result == vk::Result::eErrorOutOfDateKHR)
 	{
 		recreateSwapChain();
@@ -156,38 +273,40 @@ void VulkanApplication::drawFrame() {
 		throw std::runtime_error("failed to acquire swap chain image!");
 	}
 
+	// only reset once we know work will be submitted, otherwise the next wait on this slot never returns
+	_logicalDevice->getObject()->resetFences(1, &frame->inFlightFence);
+	submitDraws();
+	_commandBuffers->record(frameIndex, imageIndex, _drawList);
+
 	vk::SubmitInfo submitInfo = vk::SubmitInfo();
 
-	vk::Semaphore waitSemaphores[] = { _imageAvailableSemaphore };
+	vk::Semaphore waitSemaphores[] = { frame->imageAvailableSemaphore };
 	vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
-	submitInfo.waitSemaphoreCount = 1;
-	submitInfo.pWaitSemaphores = waitSemaphores;
-	submitInfo.pWaitDstStageMask = waitStages;
+	vk::Semaphore signalSemaphores[] = { frame->renderFinishedSemaphore };
+
+	// offscreen images are never acquired or presented, so there is nothing to wait on or signal
+	if (!_swapChain->isHeadless())
+	{
+		submitInfo.waitSemaphoreCount = 1;
+		submitInfo.pWaitSemaphores = waitSemaphores;
+		submitInfo.pWaitDstStageMask = waitStages;
+
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = signalSemaphores;
+	}
 
 	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = _commandBuffers->getBufferAt(imageIndex);
+	submitInfo.pCommandBuffers = _commandBuffers->getBufferAt(frameIndex);
 
-	vk::Semaphore signalSemaphores[] = { _renderFinishedSemaphore };
-	submitInfo.signalSemaphoreCount = 1;
-	submitInfo.pSignalSemaphores = signalSemaphores;
+	// everything uploaded since the last frame goes out in one batch ahead of the draws that use it
+	_uploadManager->flush();
 
-	if (_logicalDevice->getGraphicsQueue()->submit(1, &submitInfo, VK_NULL_HANDLE) != vk::Result::eSuccess)
+	if (_logicalDevice->getGraphicsQueue()->submit(1, &submitInfo, frame->inFlightFence) != vk::Result::eSuccess)
 	{
 		throw std::runtime_error("failed to submit draw command buffer!");
 	}
 
-	vk::PresentInfoKHR presentInfo = vk::PresentInfoKHR();
-
-	presentInfo.waitSemaphoreCount = 1;
-	presentInfo.pWaitSemaphores = signalSemaphores;
-
-	vk::SwapchainKHR swapChains[] = { *_swapChain->getObject() };
-	presentInfo.swapchainCount = 1;
-	presentInfo.pSwapchains = swapChains;
-
-	presentInfo.pImageIndices = &imageIndex;
-
-	result = _logicalDevice->getPresentQueue()->presentKHR(&presentInfo);
+	result = _swapChain->present(_logicalDevice->getPresentQueue(), frame->renderFinishedSemaphore, imageIndex);
 	if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR)
 	{
 		recreateSwapChain();
@@ -197,7 +316,51 @@ void VulkanApplication::drawFrame() {
 		throw std::runtime_error("failed to present swap chain image!");
 	}
 
-	_logicalDevice->getPresentQueue()->waitIdle();
+	_framePool->advance();
+}
+
+void VulkanApplication::submitDraws()
+{
+	litter::ProfileZone zone(_profiler, "submitDraws");
+
+	_drawList->clear();
+
+	// the slot keeps pointing at the placeholder until the texture has loaded
+	_textureTable->set(_textureSlot, _textureLoader->getTexture(_texture));
+	vk::DescriptorSet textureTableSet = _textureTable->update(_framePool->getCurrentIndex());
+
+	// the set points at the whole ring and the frame's region is picked by the dynamic offset at bind time,
+	// so after the first frame this is always a hit
+	litter::DescriptorSetContents cameraContents;
+	cameraContents.bindBuffer(0, vk::DescriptorType::eUniformBufferDynamic, _uniformRing->getBufferInfo(litter::VulkanCamera::getUniformSize()));
+	vk::DescriptorSet cameraSet = _descriptorSetCache->get(_pipeline->getDescriptorSetLayout(0), cameraContents);
+
+	litter::VulkanDrawItem item = litter::VulkanDrawItem();
+	if (_mesh != nullptr)
+	{
+		item.vertexBuffer = *_mesh->getVertexBuffer();
+		item.indexBuffer = *_mesh->getIndexBuffer();
+		item.indexCount = _mesh->getIndexCount();
+	}
+	else
+	{
+		item.vertexBuffer = *_textureRenderCmd->getVertexBuffer();
+		item.indexBuffer = *_textureRenderCmd->getIndexBuffer();
+		item.indexCount = static_cast<uint32_t>(_textureRenderCmd->getIndexSize());
+	}
+	item.firstIndex = 0;
+	item.vertexOffset = 0;
+	item.pipeline = _pipeline;
+	item.descriptorSet = cameraSet;
+	item.dynamicOffset = _cameraUniformOffset;
+	item.sharedDescriptorSet = textureTableSet;
+	item.firstInstance = 0;
+	item.instanceCount = 1;
+
+	ObjectConstants constants;
+	constants.model = _mesh != nullptr ? _meshModel : glm::mat4(1.0f);
+	constants.textureIndex = _textureSlot;
+	_drawList->push(item, &constants, sizeof(constants));
 }
 
 bool VulkanApplication::initWindow()
@@ -218,33 +381,83 @@ bool VulkanApplication::initWindow()
 
 bool VulkanApplication::initVulkan()
 {
-	_instance = new litter::VulkanInstance();
+	_instance = new litter::VulkanInstance(_headless);
 	setupDebugCallback();
-	_surface = new litter::VulkanSurface(_instance, _window);
+	_surface = _headless ? nullptr : new litter::VulkanSurface(_instance, _window);
 	_physicalDevice = new litter::VulkanPhysicalDevice(_instance, _surface);
 	_logicalDevice = new litter::VulkanLogicalDevice(_physicalDevice);
-	_swapChain = new litter::VulkanSwapChain(_logicalDevice, _physicalDevice, _surface, _windowWidth, _windowHeight);
+	_swapChain = new litter::VulkanSwapChain(_logicalDevice, _physicalDevice, _surface, _windowWidth, _windowHeight, nullptr);
 	_imageViewPool = new litter::VulkanImageViewPool(_swapChain, _logicalDevice);
 
-	_renderPass = new litter::VulkanRenderPass(_logicalDevice, _swapChain->getImageFormat(), _physicalDevice);
+	_renderPass = new litter::VulkanRenderPass(_logicalDevice, _swapChain->getImageFormat(), _swapChain->getFinalLayout(), _physicalDevice);
 	
-	_descriptorSetLayout = new litter::VulkanDescriptorSetLayout(_logicalDevice);
-	_pipeline = new litter::VulkanPipeline(_logicalDevice, _swapChain, _descriptorSetLayout, _renderPass);
+	_descriptorSetLayoutCache = new litter::VulkanDescriptorSetLayoutCache(_logicalDevice);
+	_shaderManager = new litter::VulkanShaderManager(_logicalDevice, "shaders/cache");
+	_pipeline = new litter::VulkanPipeline(_logicalDevice, _shaderManager, _descriptorSetLayoutCache, _renderPass);
 	_commandPool = new litter::VulkanCommandPool(_logicalDevice, _physicalDevice);
-	_depthResource = new litter::VulkanDepthResource(_logicalDevice, _physicalDevice, _swapChain, _commandPool);
+	_framePool = new litter::VulkanFramePool(_logicalDevice, _framesInFlight);
+	if (!_profileOutput.empty())
+	{
+		_profiler = new litter::VulkanProfiler(_logicalDevice, _physicalDevice, _commandPool, _framePool->getFrameCount());
+		_logicalDevice->setProfiler(_profiler);
+	}
+	_depthResource = new litter::VulkanDepthResource(_logicalDevice, _physicalDevice, _swapChain);
 	_framebufferPool = new litter::VulkanFramebufferPool(_logicalDevice, _imageViewPool, _depthResource->getImageView(), _swapChain, _renderPass);
-	_imageView = new litter::VulkanImageView(_physicalDevice, _logicalDevice, _commandPool);
-	_textureRenderCmd = new litter::TextureRenderCmd(_physicalDevice, _logicalDevice, _commandPool);
-	_camera = new litter::VulkanCamera(_logicalDevice, _physicalDevice);
-	createDescriptorPool();
-	createDescriptorSet();
-	_commandBuffers = new litter::VulkanCommandBuffers(_logicalDevice, _commandPool,
-		_framebufferPool, _renderPass, _pipeline, _swapChain, &_descriptorSet, _textureRenderCmd);
-	createSemaphores();
+	_uploadManager = new litter::VulkanUploadManager(_logicalDevice, _physicalDevice, UPLOAD_STAGING_SIZE);
+	// decoding overlaps the rest of init, the texture is swapped in once its upload has landed
+	uint32_t decodeThreads = std::thread::hardware_concurrency();
+	_textureLoader = new litter::VulkanTextureLoader(_physicalDevice, _logicalDevice, _uploadManager, decodeThreads > 1 ? decodeThreads - 1 : 1);
+	_texture = _textureLoader->load(TEXTURE_PATH);
+	_textureRenderCmd = new litter::TextureRenderCmd(_physicalDevice, _logicalDevice, _uploadManager);
+	_camera = new litter::VulkanCamera();
+	_uniformRing = new litter::VulkanUniformRing(_logicalDevice, _physicalDevice, _framePool->getFrameCount(), UNIFORM_RING_FRAME_SIZE);
+	createDescriptorAllocators();
+	_textureTable = new litter::VulkanTextureTable(_logicalDevice, _physicalDevice, _descriptorSetLayoutCache,
+		_framePool->getFrameCount(), _textureLoader->getPlaceholder());
+	_textureSlot = _textureTable->allocate(_textureLoader->getTexture(_texture));
+	_drawList = new litter::VulkanDrawList();
+	_commandBuffers = new litter::VulkanCommandBuffers(_logicalDevice, _commandPool, _framePool->getFrameCount(),
+		_framebufferPool, _renderPass, _swapChain);
+
+	// the main thread records the primary buffer, the workers fill the secondaries
+	uint32_t hardwareThreads = std::thread::hardware_concurrency();
+	_threadPool = new litter::ThreadPool(hardwareThreads > 1 ? hardwareThreads - 1 : 1);
+	_parallelRecorder = new litter::VulkanParallelRecorder(_logicalDevice, _physicalDevice, _threadPool, _framePool->getFrameCount());
+	_commandBuffers->setParallelRecorder(_parallelRecorder);
+	loadMesh();
+
+	// benchmarks measure fixed shaders, only interactive runs pick up edits
+	if (!_headless)
+	{
+		_fileWatcher = new litter::FileWatcher();
+		for (const auto& path : _pipeline->getShaderPaths())
+		{
+			_fileWatcher->watch(path);
+		}
+	}
 
 	return true;
 }
 
+void VulkanApplication::loadMesh()
+{
+	if (_meshPath.empty())
+	{
+		return;
+	}
+
+	// parsed on the thread pool while this thread waits, it isn't recording anything yet
+	litter::MeshData mesh = litter::MeshLoader::load(_meshPath, _threadPool);
+	_mesh = new litter::VulkanMesh(_logicalDevice, _uploadManager, mesh);
+
+	// centered and scaled so the longest side matches the quad
+	glm::vec3 center = (mesh.boundsMin + mesh.boundsMax) * 0.5f;
+	glm::vec3 extent = mesh.boundsMax - mesh.boundsMin;
+	float longestSide = (std::max)(extent.x, (std::max)(extent.y, extent.z));
+	float scale = longestSide > 0.0f ? 1.0f / longestSide : 1.0f;
+	_meshModel = glm::scale(glm::mat4(1.0f), glm::vec3(scale)) * glm::translate(glm::mat4(1.0f), -center);
+}
+
 void VulkanApplication::setupDebugCallback()
 {
 	if (!enableValidationLayers) return;
@@ -261,103 +474,128 @@ void VulkanApplication::setupDebugCallback()
 
 void VulkanApplication::recreateSwapChain()
 {
-	_logicalDevice->getObject()->waitIdle();
-
-	_depthResource->cleanup();
-	_framebufferPool->cleanup();
-	_commandBuffers->cleanup();
-	_renderPass->cleanup();
-	_swapChain->cleanup();
-	_imageViewPool->cleanup();
-
-	_swapChain->init(_windowWidth, _windowHeight);
-	_imageViewPool->init();
-
-	_renderPass->init(_swapChain->getImageFormat(), _physicalDevice);
-	
-	_pipeline->init(_swapChain, _descriptorSetLayout, _renderPass);
-	_depthResource->init(_swapChain, _commandPool);
-	_framebufferPool->init(_imageViewPool, _depthResource->getImageView(), _swapChain, _renderPass);
-	_commandBuffers->init(_framebufferPool, _renderPass, _pipeline, _swapChain, &_descriptorSet, _textureRenderCmd);
-}
+	litter::ProfileZone zone(_profiler, "recreateSwapChain");
 
-void VulkanApplication::createDescriptorPool()
-{
-	std::array<vk::DescriptorPoolSize, 2> poolSizes = {
-		vk::DescriptorPoolSize()
-			.setType(vk::DescriptorType::eUniformBuffer)
-			.setDescriptorCount(1),
-		vk::DescriptorPoolSize()
-			.setType(vk::DescriptorType::eCombinedImageSampler)
-			.setDescriptorCount(1)
-	};
-
-	vk::DescriptorPoolCreateInfo poolInfo = vk::DescriptorPoolCreateInfo()
-		.setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()))
-		.setPPoolSizes(poolSizes.data())
-		.setMaxSets(1);
-
-	if (_logicalDevice->getObject()->createDescriptorPool(&poolInfo, nullptr, &_descriptorPool) != vk::Result::eSuccess)
+	// a minimized window reports a zero extent, which no swap chain can be created with
+	if (_windowWidth == 0 || _windowHeight == 0)
 	{
-		throw std::runtime_error("failed to create descriptor pool!");
+		return;
 	}
-}
 
-void VulkanApplication::createDescriptorSet()
-{
-	vk::DescriptorSetLayout layout[] = {*_descriptorSetLayout->getObject()};
+	// instead of draining the device, build the replacements next to the old objects and hand
+	// the old ones to the frame pool, which deletes them once the frames still using them are done
+	litter::VulkanSwapChain* oldSwapChain = _swapChain;
+	_swapChain = new litter::VulkanSwapChain(_logicalDevice, _physicalDevice, _surface, _windowWidth, _windowHeight, oldSwapChain);
+
+	_framePool->retire(_framebufferPool);
+	_framePool->retire(_depthResource);
+	_framePool->retire(_imageViewPool);
+	_framePool->retire(oldSwapChain);
 
-	vk::DescriptorSetAllocateInfo allocInfo = vk::DescriptorSetAllocateInfo()
-		.setDescriptorPool(_descriptorPool)
-		.setDescriptorSetCount(1)
-		.setPSetLayouts(layout);
+	_imageViewPool = new litter::VulkanImageViewPool(_swapChain, _logicalDevice);
 
-	if (_logicalDevice->getObject()->allocateDescriptorSets(&allocInfo, &_descriptorSet) != vk::Result::eSuccess)
+	// attachments keep their layout and load/store ops, only a new surface format needs a new render pass.
+	// the pipeline is tied to the render pass but not to the extent, so it only follows a format change
+	if (*_swapChain->getImageFormat() != *oldSwapChain->getImageFormat())
 	{
-		throw std::runtime_error("failed to allocate descriptor set!");
+		// a background rebuild may still be reading the old render pass. it has to finish before the pass is retired,
+		// its result was built for the old pass and is thrown away, the rebuild starts over against the new one
+		if (_pipelineReload.valid())
+		{
+			try
+			{
+				delete _pipelineReload.get();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+			_pipelineReloadQueued = true;
+		}
+
+		_framePool->retire(_renderPass);
+		_renderPass = new litter::VulkanRenderPass(_logicalDevice, _swapChain->getImageFormat(), _swapChain->getFinalLayout(), _physicalDevice);
+		_renderPassGeneration++;
+
+		_framePool->retire(_pipeline);
+		_pipeline = new litter::VulkanPipeline(_logicalDevice, _shaderManager, _descriptorSetLayoutCache, _renderPass);
 	}
 
-	vk::DescriptorImageInfo imageInfo = vk::DescriptorImageInfo()
-		.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-		.setImageView(*_imageView->getObject())
-		.setSampler(*_imageView->getSampler());
-
-	std::array<vk::WriteDescriptorSet, 2> descriptorWrites = {
-		vk::WriteDescriptorSet()
-			.setDstSet(_descriptorSet)
-			.setDstBinding(0)
-			.setDstArrayElement(0)
-			.setDescriptorType(vk::DescriptorType::eUniformBuffer)
-			.setDescriptorCount(1)
-			.setPBufferInfo(_camera->getBufferInfo())
-			.setPImageInfo(nullptr)
-			.setPTexelBufferView(nullptr),
-		vk::WriteDescriptorSet()
-			.setDstSet(_descriptorSet)
-			.setDstBinding(1)
-			.setDstArrayElement(0)
-			.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-			.setDescriptorCount(1)
-			.setPBufferInfo(nullptr)
-			.setPImageInfo(&imageInfo)
-			.setPTexelBufferView(nullptr)
-	};
-
-	_logicalDevice->getObject()->updateDescriptorSets(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	_depthResource = new litter::VulkanDepthResource(_logicalDevice, _physicalDevice, _swapChain);
+	_framebufferPool = new litter::VulkanFramebufferPool(_logicalDevice, _imageViewPool, _depthResource->getImageView(), _swapChain, _renderPass);
+
+	_commandBuffers->setRenderTarget(_framebufferPool, _renderPass, _swapChain);
 }
 
-void VulkanApplication::createSemaphores()
+void VulkanApplication::reloadChangedPipelines()
 {
-	vk::SemaphoreCreateInfo semaphoreInfo = vk::SemaphoreCreateInfo();
+	std::vector<std::string> changedPaths;
+	_fileWatcher->poll(&changedPaths);
+	for (const auto& path : changedPaths)
+	{
+		if (_pipeline->usesShader(path))
+		{
+			_pipelineReloadQueued = true;
+		}
+	}
 
-	if (_logicalDevice->getObject()->createSemaphore(&semaphoreInfo, nullptr, &_imageAvailableSemaphore) != vk::Result::eSuccess ||
-		_logicalDevice->getObject()->createSemaphore(&semaphoreInfo, nullptr, &_renderFinishedSemaphore) != vk::Result::eSuccess)
+	if (_pipelineReload.valid())
 	{
+		if (_pipelineReload.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			return;
+		}
 
-		throw std::runtime_error("failed to create semaphores!");
+		try
+		{
+			litter::VulkanPipeline* pipeline = _pipelineReload.get();
+			if (!pipeline->isLayoutCompatible(_pipeline))
+			{
+				// the descriptor sets were allocated for the old layout, a restart picks up the new one
+				std::cerr << "shader reload changed the descriptor or push constant layout, keeping the old pipeline." << std::endl;
+				delete pipeline;
+			}
+			else if (_pipelineReloadGeneration == _renderPassGeneration)
+			{
+				// frames still in flight keep the old pipeline alive until they complete
+				_framePool->retire(_pipeline);
+				_pipeline = pipeline;
+				std::cout << "pipeline reloaded." << std::endl;
+			}
+			else
+			{
+				// never recorded, so it can go right away
+				delete pipeline;
+				_pipelineReloadQueued = true;
+			}
+		}
+		catch (const std::runtime_error& e)
+		{
+			// keep drawing with the old pipeline until the shader compiles again
+			std::cerr << e.what() << std::endl;
+		}
+	}
+
+	if (_pipelineReloadQueued)
+	{
+		_pipelineReloadQueued = false;
+		_pipelineReloadGeneration = _renderPassGeneration;
+
+		// a dedicated thread rather than the thread pool, whose workers the parallel recorder waits on every frame
+		litter::VulkanRenderPass* renderPass = _renderPass;
+		_pipelineReload = std::async(std::launch::async, [this, renderPass]() {
+			return new litter::VulkanPipeline(_logicalDevice, _shaderManager, _descriptorSetLayoutCache, renderPass);
+		});
 	}
 }
 
+void VulkanApplication::createDescriptorAllocators()
+{
+	std::vector<litter::DescriptorPoolRatio> ratios = litter::VulkanDescriptorAllocator::getDefaultRatios();
+	_descriptorAllocator = new litter::VulkanDescriptorAllocator(_logicalDevice, DESCRIPTOR_SETS_PER_POOL, ratios);
+	_descriptorSetCache = new litter::VulkanDescriptorSetCache(_logicalDevice, _descriptorAllocator, _framePool->getFrameCount(),
+		DESCRIPTOR_SET_CACHE_CAPACITY);
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL VulkanApplication::debugCallback(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objType, uint64_t obj, size_t location, int32_t code, const char* layerPrefix, const char* msg, void* userData) {
 	std::cerr << "validation layer: " << msg << std::endl;
 
@@ -20,15 +20,55 @@
 #include "VulkanSwapChain.h"
 #include "VulkanImageView.h"
 #include "VulkanDescriptorSetLayout.h"
+#include "VulkanDescriptorSetLayoutCache.h"
 #include "RenderCommand/TextureRenderCmd.h"
+#include "VulkanMesh.h"
 #include "VulkanCamera.h"
+#include "VulkanUniformRing.h"
+#include "VulkanUploadManager.h"
+#include "VulkanTextureLoader.h"
+#include "VulkanTextureTable.h"
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanDescriptorSetCache.h"
+#include "VulkanFramePool.h"
+#include "VulkanProfiler.h"
+#include "VulkanParallelRecorder.h"
+#include "VulkanDrawList.h"
+#include "VulkanShaderManager.h"
+#include "Thread/ThreadPool.h"
+#include "Mesh/MeshLoader.h"
+#include "File/FileWatcher.h"
+
+// uniform bytes one frame may write, shared by everything drawn in it
+const vk::DeviceSize UNIFORM_RING_FRAME_SIZE = 256 * 1024;
+// staging memory shared by all uploads in flight, larger uploads get a temporary buffer
+const vk::DeviceSize UPLOAD_STAGING_SIZE = 32 * 1024 * 1024;
+// sets each descriptor pool holds, the allocator adds pools when they run out
+const uint32_t DESCRIPTOR_SETS_PER_POOL = 64;
+// distinct sets kept written before the least recently used one is recycled
+const size_t DESCRIPTOR_SET_CACHE_CAPACITY = 256;
+const std::string TEXTURE_PATH = "resources/images/lm.jpg";
+
+// the push constant block shared by shader.vert and shader.frag
+struct ObjectConstants
+{
+	glm::mat4 model;
+	uint32_t textureIndex;
+};
 
 class VulkanApplication
 {
 public:
-	VulkanApplication();
+	VulkanApplication(uint32_t framesInFlight = 2);
 	~VulkanApplication();
 
+	// renders into offscreen images without creating a window, then exits after frameLimit frames
+	void setHeadless(uint32_t width, uint32_t height, uint32_t frameLimit);
+	// records cpu and gpu zones and writes them as a chrome trace on cleanup
+	void setProfileOutput(const std::string& path);
+	// draws the mesh in place of the textured quad, scaled to fit the quad's unit square
+	void setMeshPath(const std::string& path);
+
 	bool init();
 	void run();
 	void cleanup();
@@ -37,30 +77,32 @@ private:
 	bool initWindow();
 	bool initVulkan();
 	void setupDebugCallback();
-	void createDescriptorPool();
-	void createDescriptorSet();
-	void createSemaphores();
+	void createDescriptorAllocators();
+	void loadMesh();
 	static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objType,
 		uint64_t obj, size_t location, int32_t code, const char* layerPrefix, const char* msg, void* userData);
 
 	void mainLoop();
+	void benchmarkLoop();
 	void drawFrame();
+	void submitDraws();
 	void updateUniformBuffer(float offsetX);
 	void recreateSwapChain();
+	// polls the watched shaders and swaps in pipelines rebuilt in the background, call between frames
+	void reloadChangedPipelines();
 
 private:
 	SDL_Window* _window;
 
 	vk::DebugReportCallbackEXT _callback;
 
-	vk::Semaphore _imageAvailableSemaphore;
-	vk::Semaphore _renderFinishedSemaphore;
-
-	vk::DescriptorPool _descriptorPool;
-	vk::DescriptorSet _descriptorSet;
-
 	uint32_t _windowWidth;
 	uint32_t _windowHeight;
+	uint32_t _framesInFlight;
+	bool _headless;
+	uint32_t _frameLimit;
+	std::string _profileOutput;
+	std::string _meshPath;
 
 //------------------------------------------------------------------
 	litter::VulkanInstance* _instance;
@@ -68,6 +110,7 @@ private:
 	litter::VulkanLogicalDevice* _logicalDevice;
 	litter::VulkanSurface* _surface;
 	litter::VulkanImageViewPool* _imageViewPool;
+	litter::VulkanShaderManager* _shaderManager;
 	litter::VulkanPipeline* _pipeline;
 	litter::VulkanFramebufferPool* _framebufferPool;
 	litter::VulkanRenderPass* _renderPass;
@@ -75,10 +118,37 @@ private:
 	litter::VulkanCommandBuffers* _commandBuffers;
 	litter::VulkanDepthResource* _depthResource;
 	litter::VulkanSwapChain* _swapChain;
-	litter::VulkanImageView* _imageView;
-	litter::VulkanDescriptorSetLayout* _descriptorSetLayout;
+	litter::VulkanUploadManager* _uploadManager;
+	litter::VulkanTextureLoader* _textureLoader;
+	litter::TextureHandle _texture;
+	litter::VulkanTextureTable* _textureTable;
+	// the texture's slot in the table, pushed with every draw that samples it
+	uint32_t _textureSlot;
+	litter::VulkanDescriptorSetLayoutCache* _descriptorSetLayoutCache;
+	// sets that live as long as the application
+	litter::VulkanDescriptorAllocator* _descriptorAllocator;
+	// sets that repeat from frame to frame, written once and found again by their contents
+	litter::VulkanDescriptorSetCache* _descriptorSetCache;
 	litter::TextureRenderCmd* _textureRenderCmd;
+	// null without a mesh path
+	litter::VulkanMesh* _mesh;
+	glm::mat4 _meshModel;
 	litter::VulkanCamera* _camera;
+	litter::VulkanUniformRing* _uniformRing;
+	uint32_t _cameraUniformOffset;
+	litter::VulkanFramePool* _framePool;
+	litter::VulkanProfiler* _profiler;
+	litter::ThreadPool* _threadPool;
+	litter::VulkanParallelRecorder* _parallelRecorder;
+	litter::VulkanDrawList* _drawList;
+	litter::FileWatcher* _fileWatcher;
+
+	std::future<litter::VulkanPipeline*> _pipelineReload;
+	// bumped whenever the render pass is replaced, a reload only commits when it was built for the current one.
+	// an address could be reused by the replacement, a count can't
+	uint64_t _renderPassGeneration;
+	uint64_t _pipelineReloadGeneration;
+	bool _pipelineReloadQueued;
 };
 
 #endif // !VULKAN_APPLICATION_H_
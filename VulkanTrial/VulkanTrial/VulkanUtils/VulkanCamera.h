@@ -5,27 +5,24 @@
 #include "VulkanHeader.h"
 
 namespace litter {
-	class VulkanPhysicalDevice;
-	class VulkanLogicalDevice;
+	class VulkanUniformRing;
 
 	class VulkanCamera : public BaseObject {
 	public:
-		VulkanCamera(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice);
+		VulkanCamera();
 		~VulkanCamera();
 
 		void setSize(uint32_t width, uint32_t height);
-		void update(float offset);
-		vk::DescriptorBufferInfo* getBufferInfo();
+		// writes this frame's view and projection into the ring and returns their dynamic offset,
+		// model matrices are pushed per draw
+		uint32_t update(float offset, VulkanUniformRing* uniformRing);
+		// the range a shader reads at each offset
+		static vk::DeviceSize getUniformSize();
 
 	private:
-		vk::Buffer _uniformBuffer;
-		vk::DeviceMemory _uniformBufferMemory;
-		vk::DescriptorBufferInfo _bufferInfo;
 		uint32_t _width;
 		uint32_t _height;
 		float _x;
-
-		VulkanLogicalDevice* _logicalDevice;
 	};
 }
 
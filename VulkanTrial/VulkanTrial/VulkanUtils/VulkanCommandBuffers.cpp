@@ -4,26 +4,31 @@
 #include "VulkanFramebufferPool.h"
 #include "VulkanRenderPass.h"
 #include "VulkanPipeline.h"
+#include "VulkanDescriptorSetLayout.h"
 #include "VulkanSwapChain.h"
-#include "RenderCommand/TextureRenderCmd.h"
+#include "VulkanProfiler.h"
+#include "VulkanParallelRecorder.h"
+#include "VulkanDrawList.h"
 
 namespace litter {
-	VulkanCommandBuffers::VulkanCommandBuffers(VulkanLogicalDevice* logicalDevice, VulkanCommandPool* commandPool,
-		VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanPipeline* pipeline,
-		VulkanSwapChain* swapChain, vk::DescriptorSet* descriptorSet, TextureRenderCmd* renderCmd) {
+	VulkanCommandBuffers::VulkanCommandBuffers(VulkanLogicalDevice* logicalDevice, VulkanCommandPool* commandPool, uint32_t frameCount,
+		VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanSwapChain* swapChain) {
 		_logicalDevice = logicalDevice;
 		_commandPool = commandPool;
+		_frameCount = frameCount;
+		_recorder = nullptr;
 
-		init(framebufferPool,  renderPass, pipeline, swapChain, descriptorSet, renderCmd);
+		init(framebufferPool, renderPass, swapChain);
 	}
 
 	VulkanCommandBuffers::~VulkanCommandBuffers() {
 		cleanup();
 	}
 
-	void VulkanCommandBuffers::init(VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanPipeline* pipeline,
-		VulkanSwapChain* swapChain, vk::DescriptorSet* descriptorSet, TextureRenderCmd* renderCmd) {
-		_commandBuffers.resize(framebufferPool->getFramebufferCount());
+	void VulkanCommandBuffers::init(VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanSwapChain* swapChain) {
+		setRenderTarget(framebufferPool, renderPass, swapChain);
+
+		_commandBuffers.resize(_frameCount);
 
 		vk::CommandBufferAllocateInfo allocInfo = vk::CommandBufferAllocateInfo();
 		allocInfo.commandPool = *_commandPool->getObject();
@@ -33,54 +38,158 @@ namespace litter {
 		if (_logicalDevice->getObject()->allocateCommandBuffers(&allocInfo, _commandBuffers.data()) != vk::Result::eSuccess) {
 			throw std::runtime_error("failed to allocate command buffers!");
 		}
+	}
 
-		for (size_t i = 0; i < _commandBuffers.size(); i++) {
-			vk::CommandBufferBeginInfo beginInfo = vk::CommandBufferBeginInfo();
-			beginInfo.flags = vk::CommandBufferUsageFlagBits::eSimultaneousUse;
-
-			_commandBuffers[i].begin(&beginInfo);
+	void VulkanCommandBuffers::cleanup() {
+		_logicalDevice->getObject()->freeCommandBuffers(*_commandPool->getObject(), static_cast<uint32_t>(_commandBuffers.size()), _commandBuffers.data());
+	}
 
-			vk::RenderPassBeginInfo renderPassInfo = vk::RenderPassBeginInfo();
-			renderPassInfo.renderPass = *renderPass->getObject();
-			renderPassInfo.framebuffer = *framebufferPool->getFramebufferAt(i);
-			renderPassInfo.renderArea.offset = { 0, 0 };
-			renderPassInfo.renderArea.extent = *swapChain->getExtent();
+	void VulkanCommandBuffers::setRenderTarget(VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanSwapChain* swapChain) {
+		_framebufferPool = framebufferPool;
+		_renderPass = renderPass;
+		_swapChain = swapChain;
+	}
 
-			std::array<float, 4> clearColorValue = { 0.0f, 0.0f, 0.0f, 1.0f };
+	void VulkanCommandBuffers::setParallelRecorder(VulkanParallelRecorder* recorder) {
+		_recorder = recorder;
+	}
 
-			std::array<vk::ClearValue, 2> clearValues = {
-				vk::ClearValue()
-				.setColor(vk::ClearColorValue(clearColorValue)),
-				vk::ClearValue()
-				.setDepthStencil(vk::ClearDepthStencilValue(1.0f, 0))
-			};
-			renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-			renderPassInfo.pClearValues = clearValues.data();
+	void VulkanCommandBuffers::record(size_t frameIndex, uint32_t imageIndex, VulkanDrawList* drawList) {
+		vk::CommandBuffer& commandBuffer = _commandBuffers[frameIndex];
 
-			_commandBuffers[i].beginRenderPass(&renderPassInfo, vk::SubpassContents::eInline);
+		commandBuffer.reset(vk::CommandBufferResetFlags());
 
-			_commandBuffers[i].bindPipeline(vk::PipelineBindPoint::eGraphics, *pipeline->getObject());
+		vk::CommandBufferBeginInfo beginInfo = vk::CommandBufferBeginInfo();
+		beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
 
-			vk::Buffer vertexBuffers[] = { *renderCmd->getVertexBuffer() };
-			VkDeviceSize offsets[] = { 0 };
-			_commandBuffers[i].bindVertexBuffers(0, 1, vertexBuffers, offsets);
-			_commandBuffers[i].bindIndexBuffer(*renderCmd->getIndexBuffer(), 0, vk::IndexType::eUint32);
+		commandBuffer.begin(&beginInfo);
 
-			_commandBuffers[i].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline->getPiprlineLayout(), 0, 1, descriptorSet, 0, nullptr);
+		VulkanProfiler* profiler = _logicalDevice->getProfiler();
+		uint32_t profileZone = UINT32_MAX;
+		if (profiler != nullptr) {
+			profiler->resetQueries(&commandBuffer, (uint32_t)frameIndex);
+			profileZone = profiler->beginGpuZone(&commandBuffer, (uint32_t)frameIndex, "renderPass");
+		}
 
-			_commandBuffers[i].drawIndexed((uint32_t)renderCmd->getIndexSize(), 1, 0, 0, 0);
+		vk::RenderPassBeginInfo renderPassInfo = vk::RenderPassBeginInfo();
+		renderPassInfo.renderPass = *_renderPass->getObject();
+		renderPassInfo.framebuffer = *_framebufferPool->getFramebufferAt(imageIndex);
+		renderPassInfo.renderArea.offset = vk::Offset2D(0, 0);
+		renderPassInfo.renderArea.extent = *_swapChain->getExtent();
+
+		std::array<float, 4> clearColorValue = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+		std::array<vk::ClearValue, 2> clearValues = {
+			vk::ClearValue()
+			.setColor(vk::ClearColorValue(clearColorValue)),
+			vk::ClearValue()
+			.setDepthStencil(vk::ClearDepthStencilValue(1.0f, 0))
+		};
+		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+		renderPassInfo.pClearValues = clearValues.data();
+
+		uint32_t drawCount = drawList->getItemCount();
+		bool parallel = _recorder != nullptr && _recorder->shouldRecordInParallel(drawCount);
+
+		if (parallel) {
+			commandBuffer.beginRenderPass(&renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+
+			std::vector<vk::CommandBuffer> secondaryBuffers = _recorder->record((uint32_t)frameIndex, renderPassInfo.renderPass, renderPassInfo.framebuffer,
+				drawCount, [this, drawList](vk::CommandBuffer* secondaryBuffer, uint32_t first, uint32_t count) {
+					recordDraws(secondaryBuffer, drawList, first, count);
+				});
+			commandBuffer.executeCommands(static_cast<uint32_t>(secondaryBuffers.size()), secondaryBuffers.data());
+		} else {
+			commandBuffer.beginRenderPass(&renderPassInfo, vk::SubpassContents::eInline);
+			recordDraws(&commandBuffer, drawList, 0, drawCount);
+		}
 
-			_commandBuffers[i].endRenderPass();
+		commandBuffer.endRenderPass();
 
-			_commandBuffers[i].end();
+		if (profiler != nullptr) {
+			profiler->endGpuZone(&commandBuffer, (uint32_t)frameIndex, profileZone);
 		}
-	}
 
-	void VulkanCommandBuffers::cleanup() {
-		_logicalDevice->getObject()->freeCommandBuffers(*_commandPool->getObject(), static_cast<uint32_t>(_commandBuffers.size()), _commandBuffers.data());
+		commandBuffer.end();
 	}
 
 	vk::CommandBuffer* VulkanCommandBuffers::getBufferAt(size_t idx) {
 		return &(_commandBuffers[idx]);
 	}
+
+	void VulkanCommandBuffers::recordDraws(vk::CommandBuffer* commandBuffer, VulkanDrawList* drawList, uint32_t first, uint32_t count) {
+		// consecutive items usually share most of their state, only rebind what actually changes
+		VulkanPipeline* boundPipeline = nullptr;
+		vk::DescriptorSet boundDescriptorSet;
+		vk::DescriptorSet boundSharedDescriptorSet;
+		uint32_t boundDynamicOffset = 0;
+		vk::Buffer boundVertexBuffer;
+		vk::Buffer boundIndexBuffer;
+
+		vk::Extent2D extent = *_swapChain->getExtent();
+
+		vk::Viewport viewport = vk::Viewport()
+			.setX(0.0f)
+			.setY(0.0f)
+			.setWidth((float)extent.width)
+			.setHeight((float)extent.height)
+			.setMinDepth(0.0f)
+			.setMaxDepth(1.0f);
+
+		vk::Rect2D scissor = vk::Rect2D()
+			.setOffset(vk::Offset2D()
+				.setX(0)
+				.setY(0))
+			.setExtent(extent);
+
+		// every pipeline leaves these dynamic, so they survive pipeline switches within the buffer
+		commandBuffer->setViewport(0, 1, &viewport);
+		commandBuffer->setScissor(0, 1, &scissor);
+
+		for (uint32_t i = first; i < first + count; i++) {
+			VulkanDrawItem* item = drawList->getItemAt(i);
+
+			if (item->pipeline != boundPipeline) {
+				commandBuffer->bindPipeline(vk::PipelineBindPoint::eGraphics, *item->pipeline->getObject());
+				boundPipeline = item->pipeline;
+				boundDescriptorSet = vk::DescriptorSet();
+				boundSharedDescriptorSet = vk::DescriptorSet();
+			}
+
+			// push constant only pipelines have no set to bind
+			if (item->pipeline->getDescriptorSetLayoutCount() > 0) {
+				uint32_t dynamicOffsetCount = item->pipeline->getDescriptorSetLayout(0)->getDynamicOffsetCount();
+				if (item->descriptorSet != boundDescriptorSet || (dynamicOffsetCount > 0 && item->dynamicOffset != boundDynamicOffset)) {
+					commandBuffer->bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *item->pipeline->getPiprlineLayout(), 0, 1, &item->descriptorSet,
+						dynamicOffsetCount, &item->dynamicOffset);
+					boundDescriptorSet = item->descriptorSet;
+					boundDynamicOffset = item->dynamicOffset;
+				}
+			}
+
+			if (item->pipeline->getDescriptorSetLayoutCount() > 1 && item->sharedDescriptorSet && item->sharedDescriptorSet != boundSharedDescriptorSet) {
+				commandBuffer->bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *item->pipeline->getPiprlineLayout(), 1, 1, &item->sharedDescriptorSet,
+					0, nullptr);
+				boundSharedDescriptorSet = item->sharedDescriptorSet;
+			}
+
+			if (item->vertexBuffer != boundVertexBuffer) {
+				VkDeviceSize offsets[] = { 0 };
+				commandBuffer->bindVertexBuffers(0, 1, &item->vertexBuffer, offsets);
+				boundVertexBuffer = item->vertexBuffer;
+			}
+
+			if (item->indexBuffer != boundIndexBuffer) {
+				commandBuffer->bindIndexBuffer(item->indexBuffer, 0, vk::IndexType::eUint32);
+				boundIndexBuffer = item->indexBuffer;
+			}
+
+			if (item->pushConstantSize > 0) {
+				const vk::PushConstantRange& range = item->pipeline->getPushConstantRange();
+				commandBuffer->pushConstants(*item->pipeline->getPiprlineLayout(), range.stageFlags, 0, item->pushConstantSize, item->pushConstants);
+			}
+
+			commandBuffer->drawIndexed(item->indexCount, item->instanceCount, item->firstIndex, item->vertexOffset, item->firstInstance);
+		}
+	}
 }
\ No newline at end of file
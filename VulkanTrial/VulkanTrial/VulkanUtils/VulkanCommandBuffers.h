@@ -9,27 +9,42 @@ namespace litter {
 	class VulkanCommandPool;
 	class VulkanFramebufferPool;
 	class VulkanRenderPass;
-	class VulkanPipeline;
 	class VulkanSwapChain;
-	class TextureRenderCmd;
+	class VulkanParallelRecorder;
+	class VulkanDrawList;
 
 	class VulkanCommandBuffers : public BaseObject {
 	public:
-		VulkanCommandBuffers(VulkanLogicalDevice* logicalDevice, VulkanCommandPool* commandPool,
-			VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanPipeline* pipeline,
-			VulkanSwapChain* swapChain, vk::DescriptorSet* descriptorSet, TextureRenderCmd* renderCmd);
+		VulkanCommandBuffers(VulkanLogicalDevice* logicalDevice, VulkanCommandPool* commandPool, uint32_t frameCount,
+			VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanSwapChain* swapChain);
 		~VulkanCommandBuffers();
-		void init(VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanPipeline* pipeline,
-			VulkanSwapChain* swapChain, vk::DescriptorSet* descriptorSet, TextureRenderCmd* renderCmd);
+		void init(VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanSwapChain* swapChain);
 		void cleanup();
 
+		// points recording at new targets after the swap chain was recreated, the buffers themselves are kept
+		void setRenderTarget(VulkanFramebufferPool* framebufferPool, VulkanRenderPass* renderPass, VulkanSwapChain* swapChain);
+
+		// optional, large frames are split into secondary buffers recorded on worker threads
+		void setParallelRecorder(VulkanParallelRecorder* recorder);
+
+		// one buffer per frame in flight, reset and re-recorded from the draw list once that frame's fence has signaled
+		void record(size_t frameIndex, uint32_t imageIndex, VulkanDrawList* drawList);
 		vk::CommandBuffer* getBufferAt(size_t idx);
 
+	private:
+		// binds everything it needs itself, secondary buffers inherit no state from the primary
+		void recordDraws(vk::CommandBuffer* commandBuffer, VulkanDrawList* drawList, uint32_t first, uint32_t count);
+
 	private:
 		std::vector<vk::CommandBuffer> _commandBuffers;
+		uint32_t _frameCount;
 
 		VulkanLogicalDevice* _logicalDevice;
 		VulkanCommandPool* _commandPool;
+		VulkanFramebufferPool* _framebufferPool;
+		VulkanRenderPass* _renderPass;
+		VulkanSwapChain* _swapChain;
+		VulkanParallelRecorder* _recorder;
 	};
 }
 
@@ -12,6 +12,8 @@ namespace litter {
 
 		vk::CommandPoolCreateInfo poolInfo = vk::CommandPoolCreateInfo();
 		poolInfo.queueFamilyIndex = queueFamilyIndices->graphicsFamily;
+		// frame command buffers are re-recorded every time their slot comes around
+		poolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
 
 		if (_logicalDevice->getObject()->createCommandPool(&poolInfo, nullptr, &_commandPool) != vk::Result::eSuccess) {
 			throw std::runtime_error("failed to create command pool!");
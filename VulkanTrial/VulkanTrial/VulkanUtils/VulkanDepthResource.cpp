@@ -1,24 +1,24 @@
 #include "VulkanDepthResource.h"
 #include "VulkanLogicalDevice.h"
 #include "VulkanPhysicalDevice.h"
-#include "VulkanSingleTimeCommand.h"
-#include "VulkanCommandPool.h"
 #include "VulkanSwapChain.h"
 
 namespace litter {
 	VulkanDepthResource::VulkanDepthResource(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
-		VulkanSwapChain* swapChain, VulkanCommandPool* commandPool) {
+		VulkanSwapChain* swapChain) {
 		_logicalDevice = logicalDevice;
 		_physicalDevice = physicalDevice;
 
-		init(swapChain, commandPool);
+		init(swapChain);
 	}
 
 	VulkanDepthResource::~VulkanDepthResource() {
 		cleanup();
 	}
 
-	void VulkanDepthResource::init(VulkanSwapChain* swapChain, VulkanCommandPool* commandPool) {
+	// no layout transition is recorded here, the render pass takes the image from undefined on first use.
+	// a single time command would drain the graphics queue, which recreation has to avoid
+	void VulkanDepthResource::init(VulkanSwapChain* swapChain) {
 		vk::Format depthFormat = *_physicalDevice->getDepthFormat();
 
 		createImage(swapChain->getExtentWidth(), swapChain->getExtentHeight(), depthFormat);
@@ -39,42 +39,13 @@ namespace litter {
 		if (_logicalDevice->getObject()->createImageView(&viewInfo, nullptr, &_depthImageView) != vk::Result::eSuccess) {
 			throw std::runtime_error("failed to create texture image view!");
 		}
-
-		litter::VulkanSingleTimeCommand singleCmd(_logicalDevice, commandPool);
-
-		vk::ImageMemoryBarrier barrier = vk::ImageMemoryBarrier()
-			.setOldLayout(vk::ImageLayout::eUndefined)
-			.setNewLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
-			.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-			.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-			.setImage(_depthImage)
-			.setSubresourceRange(
-				vk::ImageSubresourceRange()
-				.setAspectMask(vk::ImageAspectFlagBits::eColor)
-				.setBaseMipLevel(0)
-				.setLevelCount(1)
-				.setBaseArrayLayer(0)
-				.setLayerCount(1)
-			);
-
-		barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eDepth;
-		if (depthFormat == vk::Format::eD32SfloatS8Uint || depthFormat == vk::Format::eD24UnormS8Uint) {
-			barrier.subresourceRange.aspectMask |= vk::ImageAspectFlagBits::eStencil;
-		}
-		barrier.srcAccessMask = vk::AccessFlags();
-		barrier.dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
-
-		singleCmd.getObject()->pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTopOfPipe, vk::DependencyFlags(),
-			0, nullptr,
-			0, nullptr,
-			1, &barrier);
 	}
 
 	void VulkanDepthResource::cleanup() {
 		vk::Device* vkDevice = _logicalDevice->getObject();
 		vkDevice->destroyImageView(_depthImageView, nullptr);
 		vkDevice->destroyImage(_depthImage, nullptr);
-		vkDevice->freeMemory(_depthImageMemory, nullptr);
+		_logicalDevice->getMemoryAllocator()->free(&_depthImageAllocation);
 	}
 
 	vk::ImageView* VulkanDepthResource::getImageView() {
@@ -105,33 +76,7 @@ namespace litter {
 			throw std::runtime_error("failed to create image!");
 		}
 
-		vk::MemoryRequirements memRequirements;
-		_logicalDevice->getObject()->getImageMemoryRequirements(_depthImage, &memRequirements);
-
-		vk::PhysicalDeviceMemoryProperties memProperties;
-		_physicalDevice->getObject()->getMemoryProperties(&memProperties);
-		vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
-		int memoryTypeIndex = -1;
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
-		{
-			if ((memRequirements.memoryTypeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-			{
-				memoryTypeIndex = i;
-				break;
-			}
-		}
-		if (memoryTypeIndex == -1) {
-			throw std::runtime_error("failed to find suitable memory type!");
-		}
-
-		vk::MemoryAllocateInfo allocInfo = vk::MemoryAllocateInfo()
-			.setAllocationSize(memRequirements.size)
-			.setMemoryTypeIndex(memoryTypeIndex);
-
-		if (_logicalDevice->getObject()->allocateMemory(&allocInfo, nullptr, &_depthImageMemory) != vk::Result::eSuccess) {
-			throw std::runtime_error("failed to allocate image memory!");
-		}
-
-		_logicalDevice->getObject()->bindImageMemory(_depthImage, _depthImageMemory, 0);
+		// dedicated, an attachment this size would pin most of a shared block and it is replaced on every resize
+		_depthImageAllocation = _logicalDevice->getMemoryAllocator()->allocateImage(_depthImage, vk::MemoryPropertyFlagBits::eDeviceLocal, true);
 	}
 }
@@ -3,19 +3,19 @@
 
 #include "Base/BaseObject.h"
 #include "VulkanHeader.h"
+#include "VulkanMemoryAllocator.h"
 
 namespace litter {
 	class VulkanPhysicalDevice;
 	class VulkanLogicalDevice;
-	class VulkanCommandPool;
 	class VulkanSwapChain;
 
 	class VulkanDepthResource : public BaseObject {
 	public:
 		VulkanDepthResource(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
-			VulkanSwapChain* swapChain, VulkanCommandPool* commandPool);
+			VulkanSwapChain* swapChain);
 		~VulkanDepthResource();
-		void init(VulkanSwapChain* swapChain, VulkanCommandPool* commandPool);
+		void init(VulkanSwapChain* swapChain);
 		void cleanup();
 
 		vk::ImageView* getImageView();
@@ -24,7 +24,7 @@ namespace litter {
 
 	private:
 		vk::Image _depthImage;
-		vk::DeviceMemory _depthImageMemory;
+		VulkanAllocation _depthImageAllocation;
 		vk::ImageView _depthImageView;
 
 		VulkanLogicalDevice* _logicalDevice;
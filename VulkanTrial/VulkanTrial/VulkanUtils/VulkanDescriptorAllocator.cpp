@@ -0,0 +1,116 @@
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanLogicalDevice.h"
+#include "VulkanDescriptorSetLayout.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanDescriptorAllocator::VulkanDescriptorAllocator(VulkanLogicalDevice* logicalDevice, uint32_t setsPerPool, const std::vector<DescriptorPoolRatio>& ratios) {
+		_logicalDevice = logicalDevice;
+		_setsPerPool = setsPerPool;
+		_currentSetCount = 0;
+
+		for (const DescriptorPoolRatio& ratio : ratios) {
+			uint32_t count = static_cast<uint32_t>(ratio.ratio * static_cast<float>(setsPerPool));
+			_poolSizes.push_back(vk::DescriptorPoolSize()
+				.setType(ratio.type)
+				.setDescriptorCount((std::max)(count, 1u)));
+		}
+	}
+
+	VulkanDescriptorAllocator::~VulkanDescriptorAllocator() {
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		for (vk::DescriptorPool pool : _usedPools) {
+			vkDevice->destroyDescriptorPool(pool, nullptr);
+		}
+		for (vk::DescriptorPool pool : _freePools) {
+			vkDevice->destroyDescriptorPool(pool, nullptr);
+		}
+	}
+
+	vk::DescriptorSet VulkanDescriptorAllocator::allocate(VulkanDescriptorSetLayout* layout) {
+		// vulkan 1.0 has no error for an exhausted pool, allocating past it is simply invalid.
+		// so what each pool has left is counted here and the switch happens before it runs out
+		std::vector<uint32_t> needed(_poolSizes.size(), 0);
+		for (const vk::DescriptorSetLayoutBinding& binding : layout->getBindings()) {
+			size_t i = 0;
+			while (i < _poolSizes.size() && _poolSizes[i].type != binding.descriptorType) {
+				i++;
+			}
+			if (i == _poolSizes.size() || needed[i] + binding.descriptorCount > _poolSizes[i].descriptorCount) {
+				throw std::runtime_error("failed to allocate descriptor set, it doesn't fit into a pool!");
+			}
+			needed[i] += binding.descriptorCount;
+		}
+
+		bool fits = _currentPool && _currentSetCount < _setsPerPool;
+		for (size_t i = 0; fits && i < _poolSizes.size(); i++) {
+			fits = _currentDescriptorCounts[i] + needed[i] <= _poolSizes[i].descriptorCount;
+		}
+		if (!fits) {
+			_currentPool = grabPool();
+			_usedPools.push_back(_currentPool);
+			_currentSetCount = 0;
+			_currentDescriptorCounts.assign(_poolSizes.size(), 0);
+		}
+
+		vk::DescriptorSetAllocateInfo allocInfo = vk::DescriptorSetAllocateInfo()
+			.setDescriptorPool(_currentPool)
+			.setDescriptorSetCount(1)
+			.setPSetLayouts(layout->getObject());
+
+		vk::DescriptorSet descriptorSet;
+		if (_logicalDevice->getObject()->allocateDescriptorSets(&allocInfo, &descriptorSet) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to allocate descriptor set!");
+		}
+
+		_currentSetCount++;
+		for (size_t i = 0; i < _poolSizes.size(); i++) {
+			_currentDescriptorCounts[i] += needed[i];
+		}
+		return descriptorSet;
+	}
+
+	void VulkanDescriptorAllocator::reset() {
+		for (vk::DescriptorPool pool : _usedPools) {
+			_logicalDevice->getObject()->resetDescriptorPool(pool, vk::DescriptorPoolResetFlags());
+			_freePools.push_back(pool);
+		}
+		_usedPools.clear();
+		_currentPool = vk::DescriptorPool();
+	}
+
+	std::vector<DescriptorPoolRatio> VulkanDescriptorAllocator::getDefaultRatios() {
+		return {
+			{ vk::DescriptorType::eUniformBuffer, 1.0f },
+			{ vk::DescriptorType::eUniformBufferDynamic, 1.0f },
+			{ vk::DescriptorType::eCombinedImageSampler, 2.0f },
+			{ vk::DescriptorType::eStorageBuffer, 0.5f },
+			{ vk::DescriptorType::eStorageImage, 0.25f }
+		};
+	}
+
+	vk::DescriptorPool VulkanDescriptorAllocator::createPool() {
+		// no free descriptor set flag, sets only ever go back to the pool through a reset
+		vk::DescriptorPoolCreateInfo poolInfo = vk::DescriptorPoolCreateInfo()
+			.setPoolSizeCount(static_cast<uint32_t>(_poolSizes.size()))
+			.setPPoolSizes(_poolSizes.data())
+			.setMaxSets(_setsPerPool);
+
+		vk::DescriptorPool pool;
+		if (_logicalDevice->getObject()->createDescriptorPool(&poolInfo, nullptr, &pool) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create descriptor pool!");
+		}
+		return pool;
+	}
+
+	vk::DescriptorPool VulkanDescriptorAllocator::grabPool() {
+		if (_freePools.empty()) {
+			return createPool();
+		}
+
+		vk::DescriptorPool pool = _freePools.back();
+		_freePools.pop_back();
+		return pool;
+	}
+}
@@ -0,0 +1,53 @@
+#ifndef VulkanDescriptorAllocator_h_
+#define VulkanDescriptorAllocator_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <vector>
+
+namespace litter {
+	class VulkanLogicalDevice;
+	class VulkanDescriptorSetLayout;
+
+	// how many descriptors of a type a pool holds per set it can hold
+	struct DescriptorPoolRatio {
+		vk::DescriptorType type;
+		float ratio;
+	};
+
+	// hands out descriptor sets from a growing list of pools. when a set no longer fits into what the current pool
+	// has left another one is taken, so callers never size anything up front. sets aren't freed one by one, reset returns every set
+	// at once and keeps the pools for reuse. not thread safe
+	class VulkanDescriptorAllocator : public BaseObject {
+	public:
+		VulkanDescriptorAllocator(VulkanLogicalDevice* logicalDevice, uint32_t setsPerPool, const std::vector<DescriptorPoolRatio>& ratios);
+		~VulkanDescriptorAllocator();
+
+		vk::DescriptorSet allocate(VulkanDescriptorSetLayout* layout);
+		// every set allocated so far becomes invalid, the gpu must be done with all of them
+		void reset();
+
+		// the ratios a pool of mostly uniform buffers and textures needs
+		static std::vector<DescriptorPoolRatio> getDefaultRatios();
+
+	private:
+		vk::DescriptorPool createPool();
+		// a reset pool when there is one, a new one otherwise
+		vk::DescriptorPool grabPool();
+
+	private:
+		uint32_t _setsPerPool;
+		std::vector<vk::DescriptorPoolSize> _poolSizes;
+		// null until the first allocate, pools are only created once something asks for a set
+		vk::DescriptorPool _currentPool;
+		// what the current pool has handed out, one count per pool size
+		uint32_t _currentSetCount;
+		std::vector<uint32_t> _currentDescriptorCounts;
+		std::vector<vk::DescriptorPool> _usedPools;
+		std::vector<vk::DescriptorPool> _freePools;
+
+		VulkanLogicalDevice* _logicalDevice;
+	};
+}
+
+#endif // !VulkanDescriptorAllocator_h_
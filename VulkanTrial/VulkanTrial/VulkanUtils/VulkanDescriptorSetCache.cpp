@@ -0,0 +1,245 @@
+#include "VulkanDescriptorSetCache.h"
+#include "VulkanLogicalDevice.h"
+#include "VulkanDescriptorSetLayout.h"
+#include "VulkanDescriptorAllocator.h"
+#include "Base/Hash.h"
+#include "StdC.h"
+
+namespace litter {
+	namespace {
+		bool isImageDescriptor(vk::DescriptorType type) {
+			return type == vk::DescriptorType::eSampler ||
+				type == vk::DescriptorType::eCombinedImageSampler ||
+				type == vk::DescriptorType::eSampledImage ||
+				type == vk::DescriptorType::eStorageImage ||
+				type == vk::DescriptorType::eInputAttachment;
+		}
+	}
+
+	void DescriptorSetContents::bindBuffer(uint32_t binding, vk::DescriptorType type, const vk::DescriptorBufferInfo& bufferInfo) {
+		Entry entry;
+		entry.binding = binding;
+		entry.type = type;
+		entry.offset = data.size();
+		entries.push_back(entry);
+
+		data.resize(entry.offset + sizeof(vk::DescriptorBufferInfo), 0);
+		vk::DescriptorBufferInfo* slot = reinterpret_cast<vk::DescriptorBufferInfo*>(data.data() + entry.offset);
+		slot->buffer = bufferInfo.buffer;
+		slot->offset = bufferInfo.offset;
+		slot->range = bufferInfo.range;
+	}
+
+	void DescriptorSetContents::bindImage(uint32_t binding, vk::DescriptorType type, const vk::DescriptorImageInfo& imageInfo) {
+		Entry entry;
+		entry.binding = binding;
+		entry.type = type;
+		entry.offset = data.size();
+		entries.push_back(entry);
+
+		// members one by one, a struct copy would bring along whatever its padding held
+		data.resize(entry.offset + sizeof(vk::DescriptorImageInfo), 0);
+		vk::DescriptorImageInfo* slot = reinterpret_cast<vk::DescriptorImageInfo*>(data.data() + entry.offset);
+		slot->sampler = imageInfo.sampler;
+		slot->imageView = imageInfo.imageView;
+		slot->imageLayout = imageInfo.imageLayout;
+	}
+
+	void DescriptorSetContents::clear() {
+		entries.clear();
+		data.clear();
+	}
+
+	VulkanDescriptorSetCache::VulkanDescriptorSetCache(VulkanLogicalDevice* logicalDevice, VulkanDescriptorAllocator* allocator,
+		uint32_t frameCount, size_t capacity) {
+		_logicalDevice = logicalDevice;
+		_allocator = allocator;
+		_frameCount = frameCount;
+		_capacity = capacity;
+		_frameNumber = 0;
+
+		_createTemplate = nullptr;
+		_destroyTemplate = nullptr;
+		_updateWithTemplate = nullptr;
+		if (_logicalDevice->isExtensionEnabled(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME)) {
+			vk::Device* vkDevice = _logicalDevice->getObject();
+			_createTemplate = (PFN_vkCreateDescriptorUpdateTemplateKHR)vkDevice->getProcAddr("vkCreateDescriptorUpdateTemplateKHR");
+			_destroyTemplate = (PFN_vkDestroyDescriptorUpdateTemplateKHR)vkDevice->getProcAddr("vkDestroyDescriptorUpdateTemplateKHR");
+			_updateWithTemplate = (PFN_vkUpdateDescriptorSetWithTemplateKHR)vkDevice->getProcAddr("vkUpdateDescriptorSetWithTemplateKHR");
+		}
+	}
+
+	VulkanDescriptorSetCache::~VulkanDescriptorSetCache() {
+		// the sets themselves belong to the allocator's pools
+		for (const UpdateTemplate& updateTemplate : _templates) {
+			_destroyTemplate((VkDevice)*_logicalDevice->getObject(), (VkDescriptorUpdateTemplateKHR)updateTemplate.updateTemplate, nullptr);
+		}
+	}
+
+	void VulkanDescriptorSetCache::beginFrame() {
+		_frameNumber++;
+	}
+
+	vk::DescriptorSet VulkanDescriptorSetCache::get(VulkanDescriptorSetLayout* layout, const DescriptorSetContents& contents) {
+		uint64_t hash = hashContents(layout, contents);
+
+		auto range = _lookup.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it) {
+			CachedSet& cached = *it->second;
+			if (cached.layout == layout && isSameEntries(cached.entries, contents.entries) && cached.data == contents.data) {
+				_sets.splice(_sets.begin(), _sets, it->second);
+				cached.lastUsedFrame = _frameNumber;
+				return cached.descriptorSet;
+			}
+		}
+
+		// when everything is still in flight the cache grows past capacity for now and shrinks back later
+		while (_sets.size() >= _capacity) {
+			if (!evict()) {
+				break;
+			}
+		}
+
+		vk::DescriptorSet descriptorSet = acquireSet(layout);
+		write(descriptorSet, layout, contents);
+
+		CachedSet cached;
+		cached.hash = hash;
+		cached.layout = layout;
+		cached.entries = contents.entries;
+		cached.data = contents.data;
+		cached.descriptorSet = descriptorSet;
+		cached.lastUsedFrame = _frameNumber;
+		_sets.push_front(cached);
+		_lookup.emplace(hash, _sets.begin());
+
+		return descriptorSet;
+	}
+
+	uint64_t VulkanDescriptorSetCache::hashContents(VulkanDescriptorSetLayout* layout, const DescriptorSetContents& contents) {
+		uint64_t hash = Hash::FNV_OFFSET_BASIS;
+		hash = Hash::fnv1a(hash, &layout, sizeof(layout));
+		for (const DescriptorSetContents::Entry& entry : contents.entries) {
+			hash = Hash::fnv1a(hash, &entry.binding, sizeof(entry.binding));
+			hash = Hash::fnv1a(hash, &entry.type, sizeof(entry.type));
+		}
+		return Hash::fnv1a(hash, contents.data.data(), contents.data.size());
+	}
+
+	bool VulkanDescriptorSetCache::isSameEntries(const std::vector<DescriptorSetContents::Entry>& a, const std::vector<DescriptorSetContents::Entry>& b) {
+		if (a.size() != b.size()) {
+			return false;
+		}
+
+		for (size_t i = 0; i < a.size(); i++) {
+			if (a[i].binding != b[i].binding || a[i].type != b[i].type || a[i].offset != b[i].offset) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	vk::DescriptorSet VulkanDescriptorSetCache::acquireSet(VulkanDescriptorSetLayout* layout) {
+		auto spare = _spareSets.find(layout);
+		if (spare == _spareSets.end() || spare->second.empty()) {
+			return _allocator->allocate(layout);
+		}
+
+		vk::DescriptorSet descriptorSet = spare->second.back();
+		spare->second.pop_back();
+		return descriptorSet;
+	}
+
+	void VulkanDescriptorSetCache::write(vk::DescriptorSet descriptorSet, VulkanDescriptorSetLayout* layout, const DescriptorSetContents& contents) {
+		if (_updateWithTemplate != nullptr) {
+			vk::DescriptorUpdateTemplateKHR updateTemplate = getTemplate(layout, contents);
+			_updateWithTemplate((VkDevice)*_logicalDevice->getObject(), (VkDescriptorSet)descriptorSet,
+				(VkDescriptorUpdateTemplateKHR)updateTemplate, contents.data.data());
+			return;
+		}
+
+		std::vector<vk::WriteDescriptorSet> descriptorWrites;
+		for (const DescriptorSetContents::Entry& entry : contents.entries) {
+			const char* info = contents.data.data() + entry.offset;
+			bool image = isImageDescriptor(entry.type);
+
+			descriptorWrites.push_back(vk::WriteDescriptorSet()
+				.setDstSet(descriptorSet)
+				.setDstBinding(entry.binding)
+				.setDstArrayElement(0)
+				.setDescriptorType(entry.type)
+				.setDescriptorCount(1)
+				.setPBufferInfo(image ? nullptr : reinterpret_cast<const vk::DescriptorBufferInfo*>(info))
+				.setPImageInfo(image ? reinterpret_cast<const vk::DescriptorImageInfo*>(info) : nullptr)
+				.setPTexelBufferView(nullptr));
+		}
+
+		_logicalDevice->getObject()->updateDescriptorSets(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	}
+
+	vk::DescriptorUpdateTemplateKHR VulkanDescriptorSetCache::getTemplate(VulkanDescriptorSetLayout* layout, const DescriptorSetContents& contents) {
+		for (const UpdateTemplate& updateTemplate : _templates) {
+			if (updateTemplate.layout == layout && isSameEntries(updateTemplate.entries, contents.entries)) {
+				return updateTemplate.updateTemplate;
+			}
+		}
+
+		// one entry per binding, each reading its info straight out of the contents' data
+		std::vector<vk::DescriptorUpdateTemplateEntryKHR> templateEntries;
+		for (const DescriptorSetContents::Entry& entry : contents.entries) {
+			bool image = isImageDescriptor(entry.type);
+
+			templateEntries.push_back(vk::DescriptorUpdateTemplateEntryKHR()
+				.setDstBinding(entry.binding)
+				.setDstArrayElement(0)
+				.setDescriptorCount(1)
+				.setDescriptorType(entry.type)
+				.setOffset(entry.offset)
+				.setStride(image ? sizeof(vk::DescriptorImageInfo) : sizeof(vk::DescriptorBufferInfo)));
+		}
+
+		vk::DescriptorUpdateTemplateCreateInfoKHR createInfo = vk::DescriptorUpdateTemplateCreateInfoKHR()
+			.setDescriptorUpdateEntryCount(static_cast<uint32_t>(templateEntries.size()))
+			.setPDescriptorUpdateEntries(templateEntries.data())
+			.setTemplateType(vk::DescriptorUpdateTemplateTypeKHR::eDescriptorSet)
+			.setDescriptorSetLayout(*layout->getObject());
+
+		VkDescriptorUpdateTemplateKHR handle;
+		if (_createTemplate((VkDevice)*_logicalDevice->getObject(), reinterpret_cast<const VkDescriptorUpdateTemplateCreateInfoKHR*>(&createInfo),
+			nullptr, &handle) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create descriptor update template!");
+		}
+
+		UpdateTemplate updateTemplate;
+		updateTemplate.layout = layout;
+		updateTemplate.entries = contents.entries;
+		updateTemplate.updateTemplate = vk::DescriptorUpdateTemplateKHR(handle);
+		_templates.push_back(updateTemplate);
+		return updateTemplate.updateTemplate;
+	}
+
+	bool VulkanDescriptorSetCache::evict() {
+		if (_sets.empty()) {
+			return false;
+		}
+
+		// a frame still in flight may have recorded the set, it can only be rewritten once that frame has completed
+		CachedSet& oldest = _sets.back();
+		if (oldest.lastUsedFrame + _frameCount > _frameNumber) {
+			return false;
+		}
+
+		auto range = _lookup.equal_range(oldest.hash);
+		for (auto it = range.first; it != range.second; ++it) {
+			if (&*it->second == &oldest) {
+				_lookup.erase(it);
+				break;
+			}
+		}
+
+		_spareSets[oldest.layout].push_back(oldest.descriptorSet);
+		_sets.pop_back();
+		return true;
+	}
+}
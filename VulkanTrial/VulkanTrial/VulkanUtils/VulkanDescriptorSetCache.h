@@ -0,0 +1,94 @@
+#ifndef VulkanDescriptorSetCache_h_
+#define VulkanDescriptorSetCache_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace litter {
+	class VulkanLogicalDevice;
+	class VulkanDescriptorSetLayout;
+	class VulkanDescriptorAllocator;
+
+	// what a set points at, one descriptor per binding. filled in the same binding order every time,
+	// the order is part of what identifies the set
+	struct DescriptorSetContents {
+		struct Entry {
+			uint32_t binding;
+			vk::DescriptorType type;
+			// into data, a vk::DescriptorBufferInfo or a vk::DescriptorImageInfo depending on the type
+			size_t offset;
+		};
+
+		std::vector<Entry> entries;
+		// laid out the way the update template reads it, padding is kept zeroed so the bytes can be compared
+		std::vector<char> data;
+
+		void bindBuffer(uint32_t binding, vk::DescriptorType type, const vk::DescriptorBufferInfo& bufferInfo);
+		void bindImage(uint32_t binding, vk::DescriptorType type, const vk::DescriptorImageInfo& imageInfo);
+		void clear();
+	};
+
+	// returns the same descriptor set for the same layout and contents, so sets that repeat every frame are
+	// written once. sets are filled through a descriptor update template per layout when the device has
+	// VK_KHR_descriptor_update_template, with plain writes otherwise. past capacity the least recently used
+	// set is rewritten for the next new contents, once no frame in flight can still be using it
+	class VulkanDescriptorSetCache : public BaseObject {
+	public:
+		VulkanDescriptorSetCache(VulkanLogicalDevice* logicalDevice, VulkanDescriptorAllocator* allocator,
+			uint32_t frameCount, size_t capacity);
+		~VulkanDescriptorSetCache();
+
+		// call once per frame after waiting on it
+		void beginFrame();
+		vk::DescriptorSet get(VulkanDescriptorSetLayout* layout, const DescriptorSetContents& contents);
+
+	private:
+		struct CachedSet {
+			uint64_t hash;
+			VulkanDescriptorSetLayout* layout;
+			std::vector<DescriptorSetContents::Entry> entries;
+			std::vector<char> data;
+			vk::DescriptorSet descriptorSet;
+			uint64_t lastUsedFrame;
+		};
+
+		struct UpdateTemplate {
+			VulkanDescriptorSetLayout* layout;
+			std::vector<DescriptorSetContents::Entry> entries;
+			vk::DescriptorUpdateTemplateKHR updateTemplate;
+		};
+
+		static uint64_t hashContents(VulkanDescriptorSetLayout* layout, const DescriptorSetContents& contents);
+		static bool isSameEntries(const std::vector<DescriptorSetContents::Entry>& a, const std::vector<DescriptorSetContents::Entry>& b);
+		// a set of the layout, taken from the evicted ones when there is one
+		vk::DescriptorSet acquireSet(VulkanDescriptorSetLayout* layout);
+		void write(vk::DescriptorSet descriptorSet, VulkanDescriptorSetLayout* layout, const DescriptorSetContents& contents);
+		vk::DescriptorUpdateTemplateKHR getTemplate(VulkanDescriptorSetLayout* layout, const DescriptorSetContents& contents);
+		// drops the least recently used set when nothing in flight can read it, false otherwise
+		bool evict();
+
+	private:
+		// most recently used at the front
+		std::list<CachedSet> _sets;
+		std::unordered_multimap<uint64_t, std::list<CachedSet>::iterator> _lookup;
+		// evicted sets, ready to be rewritten for the same layout
+		std::unordered_map<VulkanDescriptorSetLayout*, std::vector<vk::DescriptorSet>> _spareSets;
+		// one per layout and binding order, a linear search is plenty for a handful
+		std::vector<UpdateTemplate> _templates;
+		size_t _capacity;
+		uint32_t _frameCount;
+		uint64_t _frameNumber;
+
+		PFN_vkCreateDescriptorUpdateTemplateKHR _createTemplate;
+		PFN_vkDestroyDescriptorUpdateTemplateKHR _destroyTemplate;
+		PFN_vkUpdateDescriptorSetWithTemplateKHR _updateWithTemplate;
+
+		VulkanLogicalDevice* _logicalDevice;
+		VulkanDescriptorAllocator* _allocator;
+	};
+}
+
+#endif // !VulkanDescriptorSetCache_h_
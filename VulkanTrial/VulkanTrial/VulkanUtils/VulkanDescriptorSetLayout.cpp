@@ -2,28 +2,20 @@
 #include "VulkanLogicalDevice.h"
 
 namespace litter {
-	VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(VulkanLogicalDevice* logicalDevice) {
+	VulkanDescriptorSetLayout::VulkanDescriptorSetLayout(VulkanLogicalDevice* logicalDevice, const std::vector<vk::DescriptorSetLayoutBinding>& bindings) {
 		_logicalDevice = logicalDevice;
+		_bindings = bindings;
 
-		vk::DescriptorSetLayoutBinding uboLayoutBinding = vk::DescriptorSetLayoutBinding()
-			.setBinding(0)
-			.setDescriptorType(vk::DescriptorType::eUniformBuffer)
-			.setDescriptorCount(1)
-			.setStageFlags(vk::ShaderStageFlagBits::eVertex)
-			.setPImmutableSamplers(nullptr);
-
-		vk::DescriptorSetLayoutBinding samplerLayoutBinding = vk::DescriptorSetLayoutBinding()
-			.setBinding(1)
-			.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-			.setDescriptorCount(1)
-			.setStageFlags(vk::ShaderStageFlagBits::eFragment)
-			.setPImmutableSamplers(nullptr);
-
-		std::array<vk::DescriptorSetLayoutBinding, 2> bindings = { uboLayoutBinding, samplerLayoutBinding };
+		_dynamicOffsetCount = 0;
+		for (const auto& binding : _bindings) {
+			if (binding.descriptorType == vk::DescriptorType::eUniformBufferDynamic || binding.descriptorType == vk::DescriptorType::eStorageBufferDynamic) {
+				_dynamicOffsetCount += binding.descriptorCount;
+			}
+		}
 
 		vk::DescriptorSetLayoutCreateInfo layoutInfo = vk::DescriptorSetLayoutCreateInfo()
-			.setBindingCount(static_cast<uint32_t>(bindings.size()))
-			.setPBindings(bindings.data());
+			.setBindingCount(static_cast<uint32_t>(_bindings.size()))
+			.setPBindings(_bindings.data());
 
 		if (_logicalDevice->getObject()->createDescriptorSetLayout(&layoutInfo, nullptr, &_layout) != vk::Result::eSuccess) {
 			throw std::runtime_error("failed to create descriptor set layout!");
@@ -37,4 +29,12 @@ namespace litter {
 	vk::DescriptorSetLayout* VulkanDescriptorSetLayout::getObject() {
 		return &_layout;
 	}
+
+	const std::vector<vk::DescriptorSetLayoutBinding>& VulkanDescriptorSetLayout::getBindings() {
+		return _bindings;
+	}
+
+	uint32_t VulkanDescriptorSetLayout::getDynamicOffsetCount() {
+		return _dynamicOffsetCount;
+	}
 }
@@ -3,19 +3,25 @@
 
 #include "Base/BaseObject.h"
 #include "VulkanHeader.h"
+#include <vector>
 
 namespace litter {
 	class VulkanLogicalDevice;
 
 	class VulkanDescriptorSetLayout : public BaseObject {
 	public:
-		VulkanDescriptorSetLayout(VulkanLogicalDevice* logicalDevice);
+		VulkanDescriptorSetLayout(VulkanLogicalDevice* logicalDevice, const std::vector<vk::DescriptorSetLayoutBinding>& bindings);
 		~VulkanDescriptorSetLayout();
 
 		vk::DescriptorSetLayout* getObject();
+		const std::vector<vk::DescriptorSetLayoutBinding>& getBindings();
+		// how many offsets binding a set of this layout takes
+		uint32_t getDynamicOffsetCount();
 
 	private:
 		vk::DescriptorSetLayout _layout;
+		std::vector<vk::DescriptorSetLayoutBinding> _bindings;
+		uint32_t _dynamicOffsetCount;
 
 		VulkanLogicalDevice* _logicalDevice;
 	};
@@ -0,0 +1,52 @@
+#include "VulkanDescriptorSetLayoutCache.h"
+#include "VulkanDescriptorSetLayout.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanDescriptorSetLayoutCache::VulkanDescriptorSetLayoutCache(VulkanLogicalDevice* logicalDevice) {
+		_logicalDevice = logicalDevice;
+	}
+
+	VulkanDescriptorSetLayoutCache::~VulkanDescriptorSetLayoutCache() {
+		for (size_t i = 0; i < _layouts.size(); i++) {
+			delete _layouts[i];
+		}
+	}
+
+	VulkanDescriptorSetLayout* VulkanDescriptorSetLayoutCache::getLayout(std::vector<vk::DescriptorSetLayoutBinding> bindings) {
+		std::sort(bindings.begin(), bindings.end(), [](const vk::DescriptorSetLayoutBinding& a, const vk::DescriptorSetLayoutBinding& b) {
+			return a.binding < b.binding;
+		});
+
+		// pipelines may be built on a background thread while the main thread builds others
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		for (size_t i = 0; i < _layouts.size(); i++) {
+			if (isSameBindings(_layouts[i]->getBindings(), bindings)) {
+				return _layouts[i];
+			}
+		}
+
+		VulkanDescriptorSetLayout* layout = new VulkanDescriptorSetLayout(_logicalDevice, bindings);
+		_layouts.push_back(layout);
+		return layout;
+	}
+
+	bool VulkanDescriptorSetLayoutCache::isSameBindings(const std::vector<vk::DescriptorSetLayoutBinding>& a, const std::vector<vk::DescriptorSetLayoutBinding>& b) {
+		if (a.size() != b.size()) {
+			return false;
+		}
+
+		for (size_t i = 0; i < a.size(); i++) {
+			if (a[i].binding != b[i].binding ||
+				a[i].descriptorType != b[i].descriptorType ||
+				a[i].descriptorCount != b[i].descriptorCount ||
+				a[i].stageFlags != b[i].stageFlags ||
+				a[i].pImmutableSamplers != b[i].pImmutableSamplers) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
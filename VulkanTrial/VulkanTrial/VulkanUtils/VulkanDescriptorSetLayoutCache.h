@@ -0,0 +1,35 @@
+#ifndef VulkanDescriptorSetLayoutCache_h_
+#define VulkanDescriptorSetLayoutCache_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <mutex>
+#include <vector>
+
+namespace litter {
+	class VulkanLogicalDevice;
+	class VulkanDescriptorSetLayout;
+
+	// pipelines whose shaders declare the same bindings get the same layout object back,
+	// so descriptor sets allocated for one of them can be bound with any of the others
+	class VulkanDescriptorSetLayoutCache : public BaseObject {
+	public:
+		VulkanDescriptorSetLayoutCache(VulkanLogicalDevice* logicalDevice);
+		~VulkanDescriptorSetLayoutCache();
+
+		// the order of the bindings does not matter. the layout stays owned by the cache
+		VulkanDescriptorSetLayout* getLayout(std::vector<vk::DescriptorSetLayoutBinding> bindings);
+
+	private:
+		static bool isSameBindings(const std::vector<vk::DescriptorSetLayoutBinding>& a, const std::vector<vk::DescriptorSetLayoutBinding>& b);
+
+	private:
+		// a handful of distinct layouts at most, a linear search beats hashing binding lists
+		std::vector<VulkanDescriptorSetLayout*> _layouts;
+		std::mutex _mutex;
+
+		VulkanLogicalDevice* _logicalDevice;
+	};
+}
+
+#endif // !VulkanDescriptorSetLayoutCache_h_
@@ -0,0 +1,44 @@
+#include "VulkanDrawList.h"
+#include "VulkanPipeline.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanDrawList::VulkanDrawList() {
+	}
+
+	VulkanDrawList::~VulkanDrawList() {
+	}
+
+	void VulkanDrawList::clear() {
+		_items.clear();
+	}
+
+	void VulkanDrawList::push(const VulkanDrawItem& item) {
+		if (item.instanceCount == 0 || item.indexCount == 0) {
+			return;
+		}
+		if (item.pushConstantSize > item.pipeline->getPushConstantRange().size) {
+			throw std::runtime_error("draw item pushes more constants than its pipeline declares!");
+		}
+		_items.push_back(item);
+	}
+
+	void VulkanDrawList::push(const VulkanDrawItem& item, const void* pushConstants, uint32_t size) {
+		if (size > MAX_PUSH_CONSTANT_SIZE) {
+			throw std::runtime_error("push constants exceed MAX_PUSH_CONSTANT_SIZE!");
+		}
+
+		VulkanDrawItem pushed = item;
+		memcpy(pushed.pushConstants, pushConstants, size);
+		pushed.pushConstantSize = size;
+		push(pushed);
+	}
+
+	uint32_t VulkanDrawList::getItemCount() {
+		return static_cast<uint32_t>(_items.size());
+	}
+
+	VulkanDrawItem* VulkanDrawList::getItemAt(size_t idx) {
+		return &(_items[idx]);
+	}
+}
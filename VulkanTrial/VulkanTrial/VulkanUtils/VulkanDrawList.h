@@ -0,0 +1,57 @@
+#ifndef VulkanDrawList_h_
+#define VulkanDrawList_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <vector>
+
+namespace litter {
+	class VulkanPipeline;
+
+	// the size every device guarantees for maxPushConstantsSize
+	const uint32_t MAX_PUSH_CONSTANT_SIZE = 128;
+
+	struct VulkanDrawItem {
+		vk::Buffer vertexBuffer;
+		vk::Buffer indexBuffer;
+		uint32_t indexCount;
+		uint32_t firstIndex;
+		int32_t vertexOffset;
+
+		VulkanPipeline* pipeline;
+		vk::DescriptorSet descriptorSet;
+		// for the set's dynamic uniform buffer, ignored when its layout has none
+		uint32_t dynamicOffset;
+		// bound at set 1 for pipelines with more than one set, meant for sets shared by the whole frame
+		// like the texture table. consecutive items with the same set bind it once
+		vk::DescriptorSet sharedDescriptorSet;
+
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+
+		// pushed right before the draw with the pipeline's push constant stages, nothing is pushed when the size is 0
+		uint8_t pushConstants[MAX_PUSH_CONSTANT_SIZE];
+		uint32_t pushConstantSize;
+	};
+
+	// the draws of one frame. filled by the caller every frame and re-recorded from scratch,
+	// clearing keeps the storage so a steady scene does not allocate
+	class VulkanDrawList : public BaseObject {
+	public:
+		VulkanDrawList();
+		~VulkanDrawList();
+
+		void clear();
+		void push(const VulkanDrawItem& item);
+		// copies the data into the item, meant for per object values like a model matrix or an object index
+		void push(const VulkanDrawItem& item, const void* pushConstants, uint32_t size);
+
+		uint32_t getItemCount();
+		VulkanDrawItem* getItemAt(size_t idx);
+
+	private:
+		std::vector<VulkanDrawItem> _items;
+	};
+}
+
+#endif // !VulkanDrawList_h_
@@ -0,0 +1,98 @@
+#include "VulkanFramePool.h"
+#include "VulkanLogicalDevice.h"
+
+namespace litter {
+	VulkanFramePool::VulkanFramePool(VulkanLogicalDevice* logicalDevice, uint32_t frameCount) {
+		_logicalDevice = logicalDevice;
+		_currentIndex = 0;
+		_frameNumber = 0;
+
+		if (frameCount == 0) {
+			throw std::runtime_error("frame pool needs at least one frame!");
+		}
+
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		vk::SemaphoreCreateInfo semaphoreInfo = vk::SemaphoreCreateInfo();
+
+		// fences start signaled so the first wait on every slot returns immediately
+		vk::FenceCreateInfo fenceInfo = vk::FenceCreateInfo()
+			.setFlags(vk::FenceCreateFlagBits::eSignaled);
+
+		_frames.resize(frameCount);
+		for (size_t i = 0; i < _frames.size(); i++) {
+			if (vkDevice->createSemaphore(&semaphoreInfo, nullptr, &_frames[i].imageAvailableSemaphore) != vk::Result::eSuccess ||
+				vkDevice->createSemaphore(&semaphoreInfo, nullptr, &_frames[i].renderFinishedSemaphore) != vk::Result::eSuccess) {
+				throw std::runtime_error("failed to create semaphores!");
+			}
+
+			if (vkDevice->createFence(&fenceInfo, nullptr, &_frames[i].inFlightFence) != vk::Result::eSuccess) {
+				throw std::runtime_error("failed to create fence!");
+			}
+		}
+	}
+
+	VulkanFramePool::~VulkanFramePool() {
+		// the owner drains the device before tearing down, nothing retired can still be in use
+		releaseRetired(true);
+
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		for (size_t i = 0; i < _frames.size(); i++) {
+			vkDevice->destroyFence(_frames[i].inFlightFence, nullptr);
+			vkDevice->destroySemaphore(_frames[i].renderFinishedSemaphore, nullptr);
+			vkDevice->destroySemaphore(_frames[i].imageAvailableSemaphore, nullptr);
+		}
+	}
+
+	VulkanFrame* VulkanFramePool::waitCurrentFrame() {
+		VulkanFrame* frame = getCurrentFrame();
+		_logicalDevice->getObject()->waitForFences(1, &frame->inFlightFence, VK_TRUE, UINT64_MAX);
+		releaseRetired(false);
+		return frame;
+	}
+
+	void VulkanFramePool::advance() {
+		_currentIndex = (_currentIndex + 1) % static_cast<uint32_t>(_frames.size());
+		_frameNumber++;
+	}
+
+	void VulkanFramePool::retire(BaseObject* object) {
+		RetiredObject retired;
+		retired.object = object;
+		retired.frameNumber = _frameNumber;
+		_retired.push_back(retired);
+	}
+
+	uint32_t VulkanFramePool::getFrameCount() {
+		return static_cast<uint32_t>(_frames.size());
+	}
+
+	uint32_t VulkanFramePool::getCurrentIndex() {
+		return _currentIndex;
+	}
+
+	VulkanFrame* VulkanFramePool::getCurrentFrame() {
+		return &(_frames[_currentIndex]);
+	}
+
+	VulkanFrame* VulkanFramePool::getFrameAt(size_t idx) {
+		return &(_frames[idx]);
+	}
+
+	void VulkanFramePool::releaseRetired(bool all) {
+		// every slot is waited on in turn, so once the current slot's fence has signaled
+		// all frames up to _frameNumber - frameCount are done as well
+		uint64_t frameCount = _frames.size();
+
+		size_t kept = 0;
+		for (size_t i = 0; i < _retired.size(); i++) {
+			if (all || _retired[i].frameNumber + frameCount <= _frameNumber) {
+				delete _retired[i].object;
+			} else {
+				_retired[kept++] = _retired[i];
+			}
+		}
+		_retired.resize(kept);
+	}
+}
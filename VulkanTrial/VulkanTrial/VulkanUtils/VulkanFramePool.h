@@ -0,0 +1,54 @@
+#ifndef VulkanFramePool_h_
+#define VulkanFramePool_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <vector>
+
+namespace litter {
+	class VulkanLogicalDevice;
+
+	struct VulkanFrame {
+		vk::Fence inFlightFence;
+		vk::Semaphore imageAvailableSemaphore;
+		vk::Semaphore renderFinishedSemaphore;
+	};
+
+	class VulkanFramePool : public BaseObject {
+	public:
+		VulkanFramePool(VulkanLogicalDevice* logicalDevice, uint32_t frameCount);
+		~VulkanFramePool();
+
+		// blocks until the gpu has finished with the slot that is about to be reused
+		VulkanFrame* waitCurrentFrame();
+		void advance();
+
+		// takes ownership and deletes the object once every frame submitted so far has completed,
+		// so resources replaced mid-flight never need a device wait
+		void retire(BaseObject* object);
+
+		uint32_t getFrameCount();
+		uint32_t getCurrentIndex();
+		VulkanFrame* getCurrentFrame();
+		VulkanFrame* getFrameAt(size_t idx);
+
+	private:
+		void releaseRetired(bool all);
+
+	private:
+		struct RetiredObject {
+			BaseObject* object;
+			uint64_t frameNumber;
+		};
+
+		std::vector<VulkanFrame> _frames;
+		uint32_t _currentIndex;
+		// counts every advance, unlike _currentIndex it never wraps
+		uint64_t _frameNumber;
+		std::vector<RetiredObject> _retired;
+
+		VulkanLogicalDevice* _logicalDevice;
+	};
+}
+
+#endif // !VulkanFramePool_h_
@@ -1,7 +1,9 @@
 #ifndef VULKAN_HEADER_H_
 #define VULKAN_HEADER_H_
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #define SDL_MAIN_HANDLED
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -28,5 +30,10 @@ const std::vector<const char*> _deviceExtensions = {
 	VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
 
+// enabled when the device has them, headless or not
+const std::vector<const char*> _optionalDeviceExtensions = {
+	VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME
+};
+
 #endif // !VULKAN_HEADER_H_
 
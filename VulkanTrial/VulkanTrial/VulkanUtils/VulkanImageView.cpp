@@ -1,64 +1,50 @@
 #include "VulkanImageView.h"
 #include "VulkanPhysicalDevice.h"
 #include "VulkanLogicalDevice.h"
-#include "VulkanCommandPool.h"
-#include "VulkanSingleTimeCommand.h"
-
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb/stb_image.h>
-
-const std::string TEXTURE_PATH = "resources/images/lm.jpg";
+#include "VulkanUploadManager.h"
+#include "VulkanSamplerCache.h"
+#include "File/TextureFile.h"
+#include "StdC.h"
 
 namespace litter {
-	VulkanImageView::VulkanImageView(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanCommandPool* commandPool) {
+	VulkanImageView::VulkanImageView(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanUploadManager* uploadManager,
+		uint32_t width, uint32_t height, const void* pixels) {
 		_physicalDevice = physicalDevice;
 		_logicalDevice = logicalDevice;
-		_commandPool = commandPool;
-
-		createTextureImage();
-
-		vk::ImageViewCreateInfo viewInfo = vk::ImageViewCreateInfo()
-			.setImage(_image)
-			.setViewType(vk::ImageViewType::e2D)
-			.setFormat(vk::Format::eR8G8B8A8Unorm)
-			.setSubresourceRange(
-				vk::ImageSubresourceRange()
-				.setAspectMask(vk::ImageAspectFlagBits::eColor)
-				.setBaseMipLevel(0)
-				.setLevelCount(1)
-				.setBaseArrayLayer(0)
-				.setLayerCount(1)
-			);
-		if (_logicalDevice->getObject()->createImageView(&viewInfo, nullptr, &_imageView) != vk::Result::eSuccess) {
-			throw std::runtime_error("failed to create texture image view!");
+		_uploadManager = uploadManager;
+		_format = vk::Format::eR8G8B8A8Unorm;
+		_width = width;
+		_height = height;
+		_mipLevels = 1;
+		for (uint32_t size = (std::max)(_width, _height); size > 1; size /= 2) {
+			_mipLevels++;
 		}
 
-		vk::SamplerCreateInfo samplerInfo = vk::SamplerCreateInfo()
-			.setMagFilter(vk::Filter::eLinear)
-			.setMinFilter(vk::Filter::eLinear)
-			.setAddressModeU(vk::SamplerAddressMode::eRepeat)
-			.setAddressModeV(vk::SamplerAddressMode::eRepeat)
-			.setAddressModeW(vk::SamplerAddressMode::eRepeat)
-			.setAnisotropyEnable(VK_TRUE)
-			.setMaxAnisotropy(16)
-			.setBorderColor(vk::BorderColor::eIntOpaqueBlack)
-			.setUnnormalizedCoordinates(VK_FALSE)
-			.setCompareEnable(VK_FALSE)
-			.setCompareOp(vk::CompareOp::eAlways)
-			.setMipmapMode(vk::SamplerMipmapMode::eLinear);
+		createTextureImage(pixels);
+		createViewAndSampler();
+	}
 
-		if (_logicalDevice->getObject()->createSampler(&samplerInfo, nullptr, &_sampler) != vk::Result::eSuccess) {
-			throw std::runtime_error("failed to create texture sampler!");
-		}
+	VulkanImageView::VulkanImageView(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanUploadManager* uploadManager,
+		vk::Format format, uint32_t width, uint32_t height, const std::vector<std::vector<char>>& levels) {
+		_physicalDevice = physicalDevice;
+		_logicalDevice = logicalDevice;
+		_uploadManager = uploadManager;
+		_format = format;
+		_width = width;
+		_height = height;
+		_mipLevels = static_cast<uint32_t>(levels.size());
+
+		createImage();
+		uploadLevels(levels);
+		createViewAndSampler();
 	}
 
 	VulkanImageView::~VulkanImageView() {
 		vk::Device* vkDevice = _logicalDevice->getObject();
 
-		vkDevice->destroySampler(_sampler, nullptr);
 		vkDevice->destroyImageView(_imageView, nullptr);
 		vkDevice->destroyImage(_image, nullptr);
-		vkDevice->freeMemory(_imageMemory, nullptr);
+		_logicalDevice->getMemoryAllocator()->free(&_imageAllocation);
 	}
 
 	vk::ImageView* VulkanImageView::getObject() {
@@ -69,115 +55,136 @@ namespace litter {
 		return &_sampler;
 	}
 
-	void VulkanImageView::createTextureImage() {
-		int texChannels;
-		stbi_uc* pixels = stbi_load(TEXTURE_PATH.c_str(), &_width, &_height, &texChannels, STBI_rgb_alpha);
-		vk::DeviceSize imageSize = _width * _height * 4;
-		if (!pixels) {
-			throw std::runtime_error("failed to load texture image!");
-		}
-
-		vk::Buffer stagingBuffer;
-		vk::DeviceMemory stagingBufferMemory;
-		createBuffer(imageSize,
-			stagingBuffer, stagingBufferMemory);
+	uint64_t VulkanImageView::getUploadId() {
+		return _uploadId;
+	}
 
-		void* data;
-		_logicalDevice->getObject()->mapMemory(stagingBufferMemory, 0, imageSize, vk::MemoryMapFlagBits(), &data);
-		memcpy(data, pixels, static_cast<size_t>(imageSize));
-		_logicalDevice->getObject()->unmapMemory(stagingBufferMemory);
-		stbi_image_free(pixels);
+	void VulkanImageView::createTextureImage(const void* pixels) {
+		vk::DeviceSize imageSize = static_cast<vk::DeviceSize>(_width) * _height * 4;
 
 		createImage();
 
-		litter::VulkanSingleTimeCommand singleCmd0(_logicalDevice, _commandPool);
-		vk::ImageMemoryBarrier barrier0 = vk::ImageMemoryBarrier()
-			.setOldLayout(vk::ImageLayout::ePreinitialized)
-			.setNewLayout(vk::ImageLayout::eTransferDstOptimal)
-			.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-			.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-			.setImage(_image)
-			.setSubresourceRange(
-				vk::ImageSubresourceRange()
+		vk::ImageSubresourceRange range = vk::ImageSubresourceRange()
+			.setAspectMask(vk::ImageAspectFlagBits::eColor)
+			.setBaseMipLevel(0)
+			.setLevelCount(_mipLevels)
+			.setBaseArrayLayer(0)
+			.setLayerCount(1);
+
+		vk::BufferImageCopy region = vk::BufferImageCopy()
+			.setBufferOffset(0)
+			.setBufferRowLength(0)
+			.setBufferImageHeight(0)
+			.setImageSubresource(
+				vk::ImageSubresourceLayers()
 				.setAspectMask(vk::ImageAspectFlagBits::eColor)
-				.setBaseMipLevel(0)
-				.setLevelCount(1)
+				.setMipLevel(0)
 				.setBaseArrayLayer(0)
 				.setLayerCount(1)
-			);
-		barrier0.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-		barrier0.srcAccessMask = vk::AccessFlagBits::eHostWrite;
-		barrier0.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-		singleCmd0.getObject()->pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTopOfPipe, vk::DependencyFlags(),
-			0, nullptr,
-			0, nullptr,
-			1, &barrier0);
-
-		copyBufferToImage(stagingBuffer);
-
-		litter::VulkanSingleTimeCommand singleCmd1(_logicalDevice, _commandPool);
-		vk::ImageMemoryBarrier barrier1 = vk::ImageMemoryBarrier()
-			.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
-			.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-			.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-			.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			)
+			.setImageOffset(vk::Offset3D().setX(0).setY(0).setZ(0))
+			.setImageExtent(vk::Extent3D().setWidth(_width).setHeight(_height).setDepth(1));
+
+		vk::FormatProperties formatProperties;
+		_physicalDevice->getObject()->getFormatProperties(_format, &formatProperties);
+		vk::FormatFeatureFlags blitFeatures = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst |
+			vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+
+		// the pixels are copied into staging memory right away, the copy itself runs with the next flush
+		if ((formatProperties.optimalTilingFeatures & blitFeatures) == blitFeatures) {
+			_uploadId = _uploadManager->uploadImage(_image, pixels, imageSize, { region }, range, true);
+		}
+		else {
+			uploadLevels(buildMipChain(pixels));
+		}
+	}
+
+	std::vector<std::vector<char>> VulkanImageView::buildMipChain(const void* pixels) {
+		std::vector<std::vector<char>> levels(_mipLevels);
+		levels[0].assign(static_cast<const char*>(pixels), static_cast<const char*>(pixels) + static_cast<size_t>(_width) * _height * 4);
+
+		uint32_t width = _width;
+		uint32_t height = _height;
+		for (uint32_t level = 1; level < _mipLevels; level++) {
+			uint32_t nextWidth = (std::max)(width / 2, 1u);
+			uint32_t nextHeight = (std::max)(height / 2, 1u);
+			levels[level].resize(static_cast<size_t>(nextWidth) * nextHeight * 4);
+			TextureFile::downsample(reinterpret_cast<const uint8_t*>(levels[level - 1].data()), width, height,
+				reinterpret_cast<uint8_t*>(levels[level].data()));
+
+			width = nextWidth;
+			height = nextHeight;
+		}
+		return levels;
+	}
+
+	void VulkanImageView::uploadLevels(const std::vector<std::vector<char>>& levels) {
+		vk::ImageSubresourceRange range = vk::ImageSubresourceRange()
+			.setAspectMask(vk::ImageAspectFlagBits::eColor)
+			.setBaseMipLevel(0)
+			.setLevelCount(_mipLevels)
+			.setBaseArrayLayer(0)
+			.setLayerCount(1);
+
+		// one staging copy for the whole chain. every level size is a whole number of texels or blocks,
+		// so the offsets stay aligned for any format
+		std::vector<char> data;
+		std::vector<vk::BufferImageCopy> regions;
+		for (uint32_t level = 0; level < _mipLevels; level++) {
+			regions.push_back(vk::BufferImageCopy()
+				.setBufferOffset(data.size())
+				.setImageSubresource(
+					vk::ImageSubresourceLayers()
+					.setAspectMask(vk::ImageAspectFlagBits::eColor)
+					.setMipLevel(level)
+					.setBaseArrayLayer(0)
+					.setLayerCount(1)
+				)
+				.setImageExtent(vk::Extent3D()
+					.setWidth((std::max)(_width >> level, 1u))
+					.setHeight((std::max)(_height >> level, 1u))
+					.setDepth(1)));
+			data.insert(data.end(), levels[level].begin(), levels[level].end());
+		}
+
+		_uploadId = _uploadManager->uploadImage(_image, data.data(), data.size(), regions, range, false);
+	}
+
+	void VulkanImageView::createViewAndSampler() {
+		vk::ImageViewCreateInfo viewInfo = vk::ImageViewCreateInfo()
 			.setImage(_image)
+			.setViewType(vk::ImageViewType::e2D)
+			.setFormat(_format)
 			.setSubresourceRange(
 				vk::ImageSubresourceRange()
 				.setAspectMask(vk::ImageAspectFlagBits::eColor)
 				.setBaseMipLevel(0)
-				.setLevelCount(1)
+				.setLevelCount(_mipLevels)
 				.setBaseArrayLayer(0)
 				.setLayerCount(1)
 			);
-		barrier1.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-		barrier1.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-		barrier1.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-		singleCmd1.getObject()->pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTopOfPipe, vk::DependencyFlags(),
-			0, nullptr,
-			0, nullptr,
-			1, &barrier1);
-
-		_logicalDevice->getObject()->destroyBuffer(stagingBuffer, nullptr);
-		_logicalDevice->getObject()->freeMemory(stagingBufferMemory, nullptr);
-	}
-
-	void VulkanImageView::createBuffer(vk::DeviceSize size, vk::Buffer& buffer, vk::DeviceMemory& bufferMemory) {
-		vk::BufferCreateInfo bufferInfo = vk::BufferCreateInfo()
-			.setSize(size)
-			.setUsage(vk::BufferUsageFlagBits::eTransferSrc)
-			.setSharingMode(vk::SharingMode::eExclusive);
-
-		if (_logicalDevice->getObject()->createBuffer(&bufferInfo, nullptr, &buffer) != vk::Result::eSuccess) {
-			throw std::runtime_error("failed to create vertex buffer!");
-		}
-
-		vk::MemoryRequirements memRequirements;
-		_logicalDevice->getObject()->getBufferMemoryRequirements(buffer, &memRequirements);
-
-		vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
-		int memoryTypeIndex = -1;
-
-		vk::PhysicalDeviceMemoryProperties memProperties;
-		_physicalDevice->getObject()->getMemoryProperties(&memProperties);
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-			if ((memRequirements.memoryTypeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-				memoryTypeIndex = i;
-			}
-		}
-		if (memoryTypeIndex == -1) {
-			throw std::runtime_error("failed to find suitable memory type!");
+		if (_logicalDevice->getObject()->createImageView(&viewInfo, nullptr, &_imageView) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create texture image view!");
 		}
 
-		vk::MemoryAllocateInfo allocInfo = vk::MemoryAllocateInfo()
-			.setAllocationSize(memRequirements.size)
-			.setMemoryTypeIndex(memoryTypeIndex);
-
-		if (_logicalDevice->getObject()->allocateMemory(&allocInfo, nullptr, &bufferMemory) != vk::Result::eSuccess) {
-			throw std::runtime_error("failed to allocate vertex buffer memory!");
-		}
+		vk::SamplerCreateInfo samplerInfo = vk::SamplerCreateInfo()
+			.setMagFilter(vk::Filter::eLinear)
+			.setMinFilter(vk::Filter::eLinear)
+			.setAddressModeU(vk::SamplerAddressMode::eRepeat)
+			.setAddressModeV(vk::SamplerAddressMode::eRepeat)
+			.setAddressModeW(vk::SamplerAddressMode::eRepeat)
+			.setAnisotropyEnable(VK_TRUE)
+			.setMaxAnisotropy(16)
+			.setBorderColor(vk::BorderColor::eIntOpaqueBlack)
+			.setUnnormalizedCoordinates(VK_FALSE)
+			.setCompareEnable(VK_FALSE)
+			.setCompareOp(vk::CompareOp::eAlways)
+			.setMipmapMode(vk::SamplerMipmapMode::eLinear)
+			.setMinLod(0.0f)
+			.setMaxLod(VK_LOD_CLAMP_NONE);
 
-		_logicalDevice->getObject()->bindBufferMemory(buffer, bufferMemory, 0);
+		// the view already stops at the last level, an unclamped lod keeps the state the same for every texture
+		_sampler = _logicalDevice->getSamplerCache()->getSampler(samplerInfo);
 	}
 
 	void VulkanImageView::createImage()
@@ -186,16 +193,16 @@ namespace litter {
 			.setImageType(vk::ImageType::e2D)
 			.setExtent(
 				vk::Extent3D()
-				.setWidth((uint32_t)_width)
-				.setHeight((uint32_t)_height)
+				.setWidth(_width)
+				.setHeight(_height)
 				.setDepth(1)
 			)
-			.setMipLevels(1)
+			.setMipLevels(_mipLevels)
 			.setArrayLayers(1)
-			.setFormat(vk::Format::eR8G8B8A8Unorm)
+			.setFormat(_format)
 			.setTiling(vk::ImageTiling::eOptimal)
-			.setInitialLayout(vk::ImageLayout::ePreinitialized)
-			.setUsage(vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled)
+			.setInitialLayout(vk::ImageLayout::eUndefined)
+			.setUsage(vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled)
 			.setSharingMode(vk::SharingMode::eExclusive)
 			.setSamples(vk::SampleCountFlagBits::e1);
 
@@ -203,51 +210,6 @@ namespace litter {
 			throw std::runtime_error("failed to create image!");
 		}
 
-		vk::MemoryRequirements memRequirements;
-		_logicalDevice->getObject()->getImageMemoryRequirements(_image, &memRequirements);
-
-		vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
-		int memoryTypeIndex = -1;
-
-		vk::PhysicalDeviceMemoryProperties memProperties;
-		_physicalDevice->getObject()->getMemoryProperties(&memProperties);
-		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-			if ((memRequirements.memoryTypeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-				memoryTypeIndex = i;
-			}
-		}
-		if (memoryTypeIndex == -1) {
-			throw std::runtime_error("failed to find suitable memory type!");
-		}
-
-		vk::MemoryAllocateInfo allocInfo = vk::MemoryAllocateInfo()
-			.setAllocationSize(memRequirements.size)
-			.setMemoryTypeIndex(memoryTypeIndex);
-
-		if (_logicalDevice->getObject()->allocateMemory(&allocInfo, nullptr, &_imageMemory) != vk::Result::eSuccess) {
-			throw std::runtime_error("failed to allocate image memory!");
-		}
-
-		_logicalDevice->getObject()->bindImageMemory(_image, _imageMemory, 0);
-	}
-
-	void VulkanImageView::copyBufferToImage(vk::Buffer buffer) {
-		litter::VulkanSingleTimeCommand singleCmd(_logicalDevice, _commandPool);
-
-		vk::BufferImageCopy region = vk::BufferImageCopy()
-			.setBufferOffset(0)
-			.setBufferRowLength(0)
-			.setBufferImageHeight(0)
-			.setImageSubresource(
-				vk::ImageSubresourceLayers()
-				.setAspectMask(vk::ImageAspectFlagBits::eColor)
-				.setMipLevel(0)
-				.setBaseArrayLayer(0)
-				.setLayerCount(1)
-			)
-			.setImageOffset(vk::Offset3D().setX(0).setY(0).setZ(0))
-			.setImageExtent(vk::Extent3D().setWidth(_width).setHeight(_height).setDepth(1));
-
-		singleCmd.getObject()->copyBufferToImage(buffer, _image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
+		_imageAllocation = _logicalDevice->getMemoryAllocator()->allocateImage(_image, vk::MemoryPropertyFlagBits::eDeviceLocal, false);
 	}
 }
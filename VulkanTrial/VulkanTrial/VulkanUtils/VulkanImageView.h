@@ -3,36 +3,52 @@
 
 #include "Base/BaseObject.h"
 #include "VulkanHeader.h"
+#include "VulkanMemoryAllocator.h"
 
 namespace litter {
 	class VulkanPhysicalDevice;
 	class VulkanLogicalDevice;
-	class VulkanCommandPool;
+	class VulkanUploadManager;
 
+	// a sampled texture with a full mip chain. the pixels are queued on the upload manager, the image is usable
+	// by anything submitted to the graphics queue after the next flush
 	class VulkanImageView : public BaseObject {
 	public:
-		VulkanImageView(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanCommandPool* commandPool);
+		VulkanImageView(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanUploadManager* uploadManager,
+			uint32_t width, uint32_t height, const void* pixels);
+		// a pre-built chain in any sampled format, block compressed ones included. level 0 is the full size image and
+		// every level must hold exactly the blocks its extent covers, the copies read whole levels by extent
+		VulkanImageView(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanUploadManager* uploadManager,
+			vk::Format format, uint32_t width, uint32_t height, const std::vector<std::vector<char>>& levels);
 		~VulkanImageView();
 
 		vk::ImageView* getObject();
+		// shared with every texture using the same state, owned by the device's sampler cache
 		vk::Sampler* getSampler();
+		// the upload batch holding the pixels, see VulkanUploadManager::isComplete
+		uint64_t getUploadId();
 	private:
-		void createTextureImage();
-		void createBuffer(vk::DeviceSize size, vk::Buffer& buffer, vk::DeviceMemory& bufferMemory);
+		void createTextureImage(const void* pixels);
 		void createImage();
-		void copyBufferToImage(vk::Buffer buffer);
+		void createViewAndSampler();
+		// box filters the levels on the cpu for formats the device can't blit with linear filtering
+		std::vector<std::vector<char>> buildMipChain(const void* pixels);
+		void uploadLevels(const std::vector<std::vector<char>>& levels);
 
 	private:
 		vk::Image _image;
-		vk::DeviceMemory _imageMemory;
+		VulkanAllocation _imageAllocation;
 		vk::ImageView _imageView;
 		vk::Sampler _sampler;
-		int _width;
-		int _height;
+		vk::Format _format;
+		uint32_t _width;
+		uint32_t _height;
+		uint32_t _mipLevels;
+		uint64_t _uploadId;
 
 		VulkanPhysicalDevice* _physicalDevice;
 		VulkanLogicalDevice* _logicalDevice;
-		VulkanCommandPool* _commandPool;
+		VulkanUploadManager* _uploadManager;
 	};
 }
 
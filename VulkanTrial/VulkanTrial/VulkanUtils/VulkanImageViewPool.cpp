@@ -15,12 +15,7 @@ namespace litter {
 	}
 
 	void VulkanImageViewPool::init() {
-		vk::Device* vkDevice = _logicalDevice->getObject();
-
-		uint32_t imageCount;
-		vkDevice->getSwapchainImagesKHR(*_swapChain->getObject(), &imageCount, nullptr);
-		_images.resize(imageCount);
-		vkDevice->getSwapchainImagesKHR(*_swapChain->getObject(), &imageCount, _images.data());
+		_images = *_swapChain->getImages();
 
 		_imageViews.resize(_images.size());
 		for (size_t i = 0; i < _images.size(); i++) {
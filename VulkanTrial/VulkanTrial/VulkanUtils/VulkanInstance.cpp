@@ -1,7 +1,9 @@
 #include "VulkanInstance.h"
 
 namespace litter {
-	VulkanInstance::VulkanInstance() {
+	VulkanInstance::VulkanInstance(bool headless) {
+		_headless = headless;
+
 		if (enableValidationLayers && !checkValidationLayerSupport()) {
 			throw std::runtime_error("validation layers requested, but not available!");
 		}
@@ -70,8 +72,13 @@ namespace litter {
 
 	std::vector<const char*> VulkanInstance::getAvailableWSIExtensions() {
 		std::vector<const char*> extensions;
-		extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
-		extensions.push_back(VK_KHR_WIN32_SURFACE_EXTENSION_NAME);
+		// headless runs never create a surface, so they must not depend on a window system being present
+		if (!_headless) {
+			extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+			extensions.push_back(VK_KHR_WIN32_SURFACE_EXTENSION_NAME);
+#endif
+		}
 
 		if (enableValidationLayers) {
 			extensions.push_back(VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
@@ -7,7 +7,7 @@
 namespace litter {
 	class VulkanInstance : public BaseObject {
 	public:
-		VulkanInstance();
+		VulkanInstance(bool headless = false);
 		~VulkanInstance();
 
 		vk::Instance* getObject();
@@ -17,6 +17,7 @@ namespace litter {
 
 	private:
 		vk::Instance _vkInstance;
+		bool _headless;
 	};
 }
 
@@ -1,33 +1,57 @@
 #include "VulkanLogicalDevice.h"
 #include "VulkanPhysicalDevice.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanSamplerCache.h"
 #include "StdC.h"
 
 namespace litter {
 	VulkanLogicalDevice::VulkanLogicalDevice(VulkanPhysicalDevice* physicalDevice) {
+		_profiler = nullptr;
+
 		QueueFamilyIndices* indices = physicalDevice->getQueueFamilyIndices();
 
 		std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
-		std::set<int> uniqueQueueFamilies = { indices->graphicsFamily, indices->presentFamily };
+		std::set<int> uniqueQueueFamilies = { indices->graphicsFamily, indices->presentFamily, indices->transferFamily };
 
-		float queuePriority = 1.0f;
+		// only the transfer queue can be the second queue of a family
+		float queuePriorities[] = { 1.0f, 1.0f };
 		for (int queueFamily : uniqueQueueFamilies) {
+			uint32_t queueCount = queueFamily == indices->transferFamily ? indices->transferQueueIndex + 1 : 1;
+
 			vk::DeviceQueueCreateInfo queueCreateInfo = vk::DeviceQueueCreateInfo()
 				.setQueueFamilyIndex(queueFamily)
-				.setQueueCount(1)
-				.setPQueuePriorities(&queuePriority);
+				.setQueueCount(queueCount)
+				.setPQueuePriorities(queuePriorities);
 
 			queueCreateInfos.push_back(queueCreateInfo);
 		}
 
 		vk::PhysicalDeviceFeatures deviceFeatures = vk::PhysicalDeviceFeatures()
-			.setSamplerAnisotropy(VK_TRUE);
+			.setSamplerAnisotropy(VK_TRUE)
+			.setShaderSampledImageArrayDynamicIndexing(VK_TRUE);
 
 		vk::DeviceCreateInfo createInfo = vk::DeviceCreateInfo()
 			.setQueueCreateInfoCount(static_cast<uint32_t>(queueCreateInfos.size()))
 			.setPQueueCreateInfos(queueCreateInfos.data())
-			.setPEnabledFeatures(&deviceFeatures)
-			.setEnabledExtensionCount(static_cast<uint32_t>(_deviceExtensions.size()))
-			.setPpEnabledExtensionNames(_deviceExtensions.data());
+			.setPEnabledFeatures(&deviceFeatures);
+
+		std::vector<const char*> extensions;
+		if (!physicalDevice->isHeadless()) {
+			extensions = _deviceExtensions;
+		}
+		// optional ones are enabled when present, users check isExtensionEnabled and fall back without them
+		for (const char* extension : _optionalDeviceExtensions) {
+			if (physicalDevice->isExtensionSupported(extension)) {
+				extensions.push_back(extension);
+			}
+		}
+		for (const char* extension : extensions) {
+			_enabledExtensions.push_back(extension);
+		}
+
+		createInfo.setEnabledExtensionCount(static_cast<uint32_t>(extensions.size()));
+		createInfo.setPpEnabledExtensionNames(extensions.data());
 
 		if (enableValidationLayers) {
 			createInfo.setEnabledLayerCount(static_cast<uint32_t>(_layers.size()));
@@ -43,9 +67,20 @@ namespace litter {
 
 		_device.getQueue(indices->graphicsFamily, 0, &_graphicsQueue);
 		_device.getQueue(indices->presentFamily, 0, &_presentQueue);
+		_device.getQueue(indices->transferFamily, indices->transferQueueIndex, &_transferQueue);
+
+		_pipelineCache = new VulkanPipelineCache(&_device, physicalDevice, PIPELINE_CACHE_PATH);
+		_memoryAllocator = new VulkanMemoryAllocator(&_device, physicalDevice);
+		_samplerCache = new VulkanSamplerCache(&_device, physicalDevice);
 	}
 
 	VulkanLogicalDevice::~VulkanLogicalDevice() {
+		// written on shutdown only, by then every pipeline of this run has gone through the cache
+		_pipelineCache->save();
+		delete _pipelineCache;
+		delete _memoryAllocator;
+		delete _samplerCache;
+
 		_device.destroy();
 	}
 
@@ -60,4 +95,32 @@ namespace litter {
 	vk::Queue* VulkanLogicalDevice::getPresentQueue() {
 		return &_presentQueue;
 	}
+
+	vk::Queue* VulkanLogicalDevice::getTransferQueue() {
+		return &_transferQueue;
+	}
+
+	bool VulkanLogicalDevice::isExtensionEnabled(const char* name) {
+		return std::find(_enabledExtensions.begin(), _enabledExtensions.end(), name) != _enabledExtensions.end();
+	}
+
+	VulkanPipelineCache* VulkanLogicalDevice::getPipelineCache() {
+		return _pipelineCache;
+	}
+
+	VulkanMemoryAllocator* VulkanLogicalDevice::getMemoryAllocator() {
+		return _memoryAllocator;
+	}
+
+	VulkanSamplerCache* VulkanLogicalDevice::getSamplerCache() {
+		return _samplerCache;
+	}
+
+	void VulkanLogicalDevice::setProfiler(VulkanProfiler* profiler) {
+		_profiler = profiler;
+	}
+
+	VulkanProfiler* VulkanLogicalDevice::getProfiler() {
+		return _profiler;
+	}
 }
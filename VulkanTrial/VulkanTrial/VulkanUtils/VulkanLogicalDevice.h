@@ -5,7 +5,13 @@
 #include "VulkanHeader.h"
 
 namespace litter {
+	const char* const PIPELINE_CACHE_PATH = "pipeline.cache";
+
 	class VulkanPhysicalDevice;
+	class VulkanProfiler;
+	class VulkanPipelineCache;
+	class VulkanMemoryAllocator;
+	class VulkanSamplerCache;
 
 	class VulkanLogicalDevice : public BaseObject {
 	public:
@@ -15,11 +21,31 @@ namespace litter {
 		vk::Device* getObject();
 		vk::Queue* getGraphicsQueue();
 		vk::Queue* getPresentQueue();
+		// a dedicated transfer family or a second graphics queue when the device has one, else the graphics queue itself
+		vk::Queue* getTransferQueue();
+		bool isExtensionEnabled(const char* name);
+		// every pipeline is created through this, it is loaded from and saved back to PIPELINE_CACHE_PATH
+		VulkanPipelineCache* getPipelineCache();
+		// every buffer and image gets its memory from this instead of allocating it itself
+		VulkanMemoryAllocator* getMemoryAllocator();
+		// every sampler comes from this, textures with the same sampling state share one
+		VulkanSamplerCache* getSamplerCache();
+
+		// optional, null unless profiling was requested
+		void setProfiler(VulkanProfiler* profiler);
+		VulkanProfiler* getProfiler();
 
 	private:
 		vk::Device _device;
 		vk::Queue _graphicsQueue;
 		vk::Queue _presentQueue;
+		vk::Queue _transferQueue;
+		std::vector<std::string> _enabledExtensions;
+		VulkanPipelineCache* _pipelineCache;
+		VulkanMemoryAllocator* _memoryAllocator;
+		VulkanSamplerCache* _samplerCache;
+
+		VulkanProfiler* _profiler;
 	};
 }
 
@@ -0,0 +1,271 @@
+#include "VulkanMemoryAllocator.h"
+#include "VulkanPhysicalDevice.h"
+#include "StdC.h"
+
+namespace litter {
+	struct VulkanMemoryRange {
+		vk::DeviceSize offset;
+		vk::DeviceSize size;
+	};
+
+	struct VulkanMemoryBlock {
+		vk::DeviceMemory memory;
+		vk::DeviceSize size;
+		uint32_t memoryTypeIndex;
+		bool linear;
+		void* mapped;
+		uint32_t allocationCount;
+		// sorted by offset, neighbours are merged on free
+		std::vector<VulkanMemoryRange> freeRanges;
+	};
+
+	VulkanMemoryAllocator::VulkanMemoryAllocator(vk::Device* device, VulkanPhysicalDevice* physicalDevice) {
+		_device = device;
+
+		physicalDevice->getObject()->getMemoryProperties(&_memoryProperties);
+	}
+
+	VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+		for (size_t i = 0; i < _blocks.size(); i++) {
+			destroyBlock(_blocks[i]);
+		}
+	}
+
+	VulkanAllocation VulkanMemoryAllocator::allocateBuffer(vk::Buffer buffer, vk::MemoryPropertyFlags properties) {
+		vk::MemoryRequirements memRequirements;
+		_device->getBufferMemoryRequirements(buffer, &memRequirements);
+
+		VulkanAllocation allocation = allocate(memRequirements, properties, true, false);
+		_device->bindBufferMemory(buffer, allocation.memory, allocation.offset);
+		return allocation;
+	}
+
+	VulkanAllocation VulkanMemoryAllocator::allocateImage(vk::Image image, vk::MemoryPropertyFlags properties, bool dedicated) {
+		vk::MemoryRequirements memRequirements;
+		_device->getImageMemoryRequirements(image, &memRequirements);
+
+		// every image made here is optimally tiled
+		VulkanAllocation allocation = allocate(memRequirements, properties, false, dedicated);
+		_device->bindImageMemory(image, allocation.memory, allocation.offset);
+		return allocation;
+	}
+
+	void VulkanMemoryAllocator::free(VulkanAllocation* allocation) {
+		if (!allocation->memory) {
+			return;
+		}
+
+		VulkanMemoryBlock* block = allocation->block;
+		if (block == nullptr) {
+			_device->freeMemory(allocation->memory, nullptr);
+			*allocation = VulkanAllocation();
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		std::vector<VulkanMemoryRange>& ranges = block->freeRanges;
+		auto next = std::lower_bound(ranges.begin(), ranges.end(), allocation->offset, [](const VulkanMemoryRange& range, vk::DeviceSize offset) {
+			return range.offset < offset;
+		});
+
+		VulkanMemoryRange freed = { allocation->offset, allocation->size };
+		auto inserted = ranges.insert(next, freed);
+
+		auto following = inserted + 1;
+		if (following != ranges.end() && inserted->offset + inserted->size == following->offset) {
+			inserted->size += following->size;
+			ranges.erase(following);
+		}
+		if (inserted != ranges.begin()) {
+			auto previous = inserted - 1;
+			if (previous->offset + previous->size == inserted->offset) {
+				previous->size += inserted->size;
+				ranges.erase(inserted);
+			}
+		}
+
+		block->allocationCount--;
+		*allocation = VulkanAllocation();
+
+		// keep one empty block per pool around so a streaming workload does not allocate and free in a loop
+		if (block->allocationCount == 0) {
+			for (size_t i = 0; i < _blocks.size(); i++) {
+				VulkanMemoryBlock* other = _blocks[i];
+				if (other != block && other->memoryTypeIndex == block->memoryTypeIndex && other->linear == block->linear) {
+					_blocks.erase(std::find(_blocks.begin(), _blocks.end(), block));
+					destroyBlock(block);
+					break;
+				}
+			}
+		}
+	}
+
+	void VulkanMemoryAllocator::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties,
+		vk::Buffer* buffer, VulkanAllocation* allocation, const std::vector<uint32_t>& queueFamilies) {
+		vk::BufferCreateInfo bufferInfo = vk::BufferCreateInfo()
+			.setSize(size)
+			.setUsage(usage)
+			.setSharingMode(vk::SharingMode::eExclusive);
+		if (queueFamilies.size() > 1) {
+			bufferInfo.setSharingMode(vk::SharingMode::eConcurrent)
+				.setQueueFamilyIndexCount(static_cast<uint32_t>(queueFamilies.size()))
+				.setPQueueFamilyIndices(queueFamilies.data());
+		}
+
+		if (_device->createBuffer(&bufferInfo, nullptr, buffer) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create buffer!");
+		}
+
+		*allocation = allocateBuffer(*buffer, properties);
+	}
+
+	void VulkanMemoryAllocator::destroyBuffer(vk::Buffer* buffer, VulkanAllocation* allocation) {
+		_device->destroyBuffer(*buffer, nullptr);
+		*buffer = vk::Buffer();
+		free(allocation);
+	}
+
+	uint32_t VulkanMemoryAllocator::findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties) {
+		for (uint32_t i = 0; i < _memoryProperties.memoryTypeCount; i++) {
+			if ((typeBits & (1 << i)) && (_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+				return i;
+			}
+		}
+
+		throw std::runtime_error("failed to find suitable memory type!");
+	}
+
+	VulkanAllocation VulkanMemoryAllocator::allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, bool linear, bool dedicated) {
+		uint32_t memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, properties);
+
+		// anything bigger than half a block would mostly waste the rest of it
+		if (dedicated || requirements.size > getBlockSize(memoryTypeIndex) / 2) {
+			return allocateDedicated(requirements, memoryTypeIndex);
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		VulkanAllocation allocation;
+		for (size_t i = 0; i < _blocks.size(); i++) {
+			VulkanMemoryBlock* block = _blocks[i];
+			if (block->memoryTypeIndex == memoryTypeIndex && block->linear == linear && allocateFromBlock(block, requirements, &allocation)) {
+				return allocation;
+			}
+		}
+
+		VulkanMemoryBlock* block = createBlock(memoryTypeIndex, linear);
+		if (!allocateFromBlock(block, requirements, &allocation)) {
+			// only an alignment larger than the block could get here, the empty block isn't kept
+			_blocks.pop_back();
+			destroyBlock(block);
+			return allocateDedicated(requirements, memoryTypeIndex);
+		}
+		return allocation;
+	}
+
+	VulkanAllocation VulkanMemoryAllocator::allocateDedicated(const vk::MemoryRequirements& requirements, uint32_t memoryTypeIndex) {
+		vk::MemoryAllocateInfo allocInfo = vk::MemoryAllocateInfo()
+			.setAllocationSize(requirements.size)
+			.setMemoryTypeIndex(memoryTypeIndex);
+
+		VulkanAllocation allocation;
+		if (_device->allocateMemory(&allocInfo, nullptr, &allocation.memory) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to allocate memory!");
+		}
+
+		allocation.offset = 0;
+		allocation.size = requirements.size;
+		allocation.memoryTypeIndex = memoryTypeIndex;
+		allocation.mapped = mapIfHostVisible(allocation.memory, memoryTypeIndex);
+		return allocation;
+	}
+
+	vk::DeviceSize VulkanMemoryAllocator::getBlockSize(uint32_t memoryTypeIndex) {
+		// small heaps, like the host visible window into device memory, get proportionally smaller blocks
+		uint32_t heapIndex = _memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+		return (std::min)(BLOCK_SIZE, _memoryProperties.memoryHeaps[heapIndex].size / 8);
+	}
+
+	VulkanMemoryBlock* VulkanMemoryAllocator::createBlock(uint32_t memoryTypeIndex, bool linear) {
+		vk::DeviceSize blockSize = getBlockSize(memoryTypeIndex);
+
+		vk::MemoryAllocateInfo allocInfo = vk::MemoryAllocateInfo()
+			.setAllocationSize(blockSize)
+			.setMemoryTypeIndex(memoryTypeIndex);
+
+		VulkanMemoryBlock* block = new VulkanMemoryBlock();
+		if (_device->allocateMemory(&allocInfo, nullptr, &block->memory) != vk::Result::eSuccess) {
+			delete block;
+			throw std::runtime_error("failed to allocate memory block!");
+		}
+
+		block->size = blockSize;
+		block->memoryTypeIndex = memoryTypeIndex;
+		block->linear = linear;
+		block->allocationCount = 0;
+		block->mapped = mapIfHostVisible(block->memory, memoryTypeIndex);
+
+		VulkanMemoryRange whole = { 0, blockSize };
+		block->freeRanges.push_back(whole);
+
+		_blocks.push_back(block);
+		return block;
+	}
+
+	void VulkanMemoryAllocator::destroyBlock(VulkanMemoryBlock* block) {
+		// freeing the memory also unmaps it
+		_device->freeMemory(block->memory, nullptr);
+		delete block;
+	}
+
+	bool VulkanMemoryAllocator::allocateFromBlock(VulkanMemoryBlock* block, const vk::MemoryRequirements& requirements, VulkanAllocation* allocation) {
+		std::vector<VulkanMemoryRange>& ranges = block->freeRanges;
+
+		// first fit. alignment is always a power of two
+		for (size_t i = 0; i < ranges.size(); i++) {
+			VulkanMemoryRange range = ranges[i];
+			vk::DeviceSize alignedOffset = (range.offset + requirements.alignment - 1) & ~(requirements.alignment - 1);
+			vk::DeviceSize padding = alignedOffset - range.offset;
+			if (range.size < padding + requirements.size) {
+				continue;
+			}
+
+			// the padding in front stays free as its own range
+			ranges.erase(ranges.begin() + i);
+			vk::DeviceSize tail = range.size - padding - requirements.size;
+			if (tail > 0) {
+				VulkanMemoryRange after = { alignedOffset + requirements.size, tail };
+				ranges.insert(ranges.begin() + i, after);
+			}
+			if (padding > 0) {
+				VulkanMemoryRange before = { range.offset, padding };
+				ranges.insert(ranges.begin() + i, before);
+			}
+
+			allocation->memory = block->memory;
+			allocation->offset = alignedOffset;
+			allocation->size = requirements.size;
+			allocation->block = block;
+			allocation->memoryTypeIndex = block->memoryTypeIndex;
+			allocation->mapped = block->mapped != nullptr ? static_cast<char*>(block->mapped) + alignedOffset : nullptr;
+
+			block->allocationCount++;
+			return true;
+		}
+
+		return false;
+	}
+
+	void* VulkanMemoryAllocator::mapIfHostVisible(vk::DeviceMemory memory, uint32_t memoryTypeIndex) {
+		if (!(_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)) {
+			return nullptr;
+		}
+
+		void* data = nullptr;
+		if (_device->mapMemory(memory, 0, VK_WHOLE_SIZE, vk::MemoryMapFlags(), &data) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to map memory!");
+		}
+		return data;
+	}
+}
@@ -0,0 +1,71 @@
+#ifndef VulkanMemoryAllocator_h_
+#define VulkanMemoryAllocator_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <mutex>
+#include <vector>
+
+namespace litter {
+	class VulkanPhysicalDevice;
+	struct VulkanMemoryBlock;
+
+	struct VulkanAllocation {
+		VulkanAllocation()
+			: offset(0), size(0), mapped(nullptr), block(nullptr), memoryTypeIndex(0) {
+		}
+
+		vk::DeviceMemory memory;
+		vk::DeviceSize offset;
+		vk::DeviceSize size;
+		// already offset into the allocation. host visible memory stays mapped for its whole lifetime,
+		// so users write through this pointer instead of calling mapMemory themselves
+		void* mapped;
+
+		// null for dedicated allocations
+		VulkanMemoryBlock* block;
+		uint32_t memoryTypeIndex;
+	};
+
+	// hands out ranges of a few large vkDeviceMemory blocks per memory type instead of one allocation per resource.
+	// linear resources (buffers) and optimal images are kept in separate blocks, so bufferImageGranularity
+	// never has to be respected between neighbours and only the resource's own alignment is applied
+	class VulkanMemoryAllocator : public BaseObject {
+	public:
+		VulkanMemoryAllocator(vk::Device* device, VulkanPhysicalDevice* physicalDevice);
+		~VulkanMemoryAllocator();
+
+		// both allocate and bind. a dedicated allocation gets its own vkDeviceMemory, meant for large
+		// attachments that would otherwise pin a whole block
+		VulkanAllocation allocateBuffer(vk::Buffer buffer, vk::MemoryPropertyFlags properties);
+		VulkanAllocation allocateImage(vk::Image image, vk::MemoryPropertyFlags properties, bool dedicated);
+		void free(VulkanAllocation* allocation);
+
+		// more than one queue family makes the buffer concurrently shared between them
+		void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties,
+			vk::Buffer* buffer, VulkanAllocation* allocation, const std::vector<uint32_t>& queueFamilies = std::vector<uint32_t>());
+		void destroyBuffer(vk::Buffer* buffer, VulkanAllocation* allocation);
+
+		uint32_t findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties);
+
+	private:
+		VulkanAllocation allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, bool linear, bool dedicated);
+		VulkanAllocation allocateDedicated(const vk::MemoryRequirements& requirements, uint32_t memoryTypeIndex);
+		vk::DeviceSize getBlockSize(uint32_t memoryTypeIndex);
+		VulkanMemoryBlock* createBlock(uint32_t memoryTypeIndex, bool linear);
+		void destroyBlock(VulkanMemoryBlock* block);
+		bool allocateFromBlock(VulkanMemoryBlock* block, const vk::MemoryRequirements& requirements, VulkanAllocation* allocation);
+		void* mapIfHostVisible(vk::DeviceMemory memory, uint32_t memoryTypeIndex);
+
+	private:
+		static const vk::DeviceSize BLOCK_SIZE = 64 * 1024 * 1024;
+
+		std::vector<VulkanMemoryBlock*> _blocks;
+		vk::PhysicalDeviceMemoryProperties _memoryProperties;
+		std::mutex _mutex;
+
+		vk::Device* _device;
+	};
+}
+
+#endif // !VulkanMemoryAllocator_h_
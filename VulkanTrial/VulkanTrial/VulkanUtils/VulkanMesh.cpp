@@ -0,0 +1,60 @@
+#include "VulkanMesh.h"
+#include "VulkanLogicalDevice.h"
+#include "VulkanUploadManager.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanMesh::VulkanMesh(VulkanLogicalDevice* logicalDevice, VulkanUploadManager* uploadManager, const MeshData& mesh) {
+		_logicalDevice = logicalDevice;
+
+		if (mesh.vertices.empty() || mesh.indices.empty()) {
+			throw std::runtime_error("failed to create mesh, it has no triangles!");
+		}
+		if (mesh.indices.size() > UINT32_MAX) {
+			throw std::runtime_error("failed to create mesh, too many indices!");
+		}
+
+		_indexCount = static_cast<uint32_t>(mesh.indices.size());
+		_boundsMin = mesh.boundsMin;
+		_boundsMax = mesh.boundsMax;
+
+		VulkanMemoryAllocator* allocator = _logicalDevice->getMemoryAllocator();
+
+		vk::DeviceSize vertexSize = sizeof(MeshVertex) * mesh.vertices.size();
+		allocator->createBuffer(vertexSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal, &_vertexBuffer, &_vertexBufferAllocation);
+		uploadManager->uploadBuffer(_vertexBuffer, 0, mesh.vertices.data(), vertexSize);
+
+		vk::DeviceSize indexSize = sizeof(uint32_t) * mesh.indices.size();
+		allocator->createBuffer(indexSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal, &_indexBuffer, &_indexBufferAllocation);
+		uploadManager->uploadBuffer(_indexBuffer, 0, mesh.indices.data(), indexSize);
+	}
+
+	VulkanMesh::~VulkanMesh() {
+		VulkanMemoryAllocator* allocator = _logicalDevice->getMemoryAllocator();
+
+		allocator->destroyBuffer(&_vertexBuffer, &_vertexBufferAllocation);
+		allocator->destroyBuffer(&_indexBuffer, &_indexBufferAllocation);
+	}
+
+	vk::Buffer* VulkanMesh::getVertexBuffer() {
+		return &_vertexBuffer;
+	}
+
+	vk::Buffer* VulkanMesh::getIndexBuffer() {
+		return &_indexBuffer;
+	}
+
+	uint32_t VulkanMesh::getIndexCount() {
+		return _indexCount;
+	}
+
+	glm::vec3 VulkanMesh::getBoundsMin() {
+		return _boundsMin;
+	}
+
+	glm::vec3 VulkanMesh::getBoundsMax() {
+		return _boundsMax;
+	}
+}
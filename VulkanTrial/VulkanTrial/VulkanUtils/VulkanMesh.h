@@ -0,0 +1,40 @@
+#ifndef VulkanMesh_h_
+#define VulkanMesh_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include "VulkanMemoryAllocator.h"
+#include "Mesh/MeshData.h"
+
+namespace litter {
+	class VulkanLogicalDevice;
+	class VulkanUploadManager;
+
+	// a MeshData copied into device local vertex and index buffers. the copies go through the upload manager,
+	// draws submitted after its next flush see them
+	class VulkanMesh : public BaseObject {
+	public:
+		VulkanMesh(VulkanLogicalDevice* logicalDevice, VulkanUploadManager* uploadManager, const MeshData& mesh);
+		~VulkanMesh();
+
+		vk::Buffer* getVertexBuffer();
+		// 32 bit indices
+		vk::Buffer* getIndexBuffer();
+		uint32_t getIndexCount();
+		glm::vec3 getBoundsMin();
+		glm::vec3 getBoundsMax();
+
+	private:
+		uint32_t _indexCount;
+		glm::vec3 _boundsMin;
+		glm::vec3 _boundsMax;
+		vk::Buffer _vertexBuffer;
+		vk::Buffer _indexBuffer;
+		VulkanAllocation _vertexBufferAllocation;
+		VulkanAllocation _indexBufferAllocation;
+
+		VulkanLogicalDevice* _logicalDevice;
+	};
+}
+
+#endif // !VulkanMesh_h_
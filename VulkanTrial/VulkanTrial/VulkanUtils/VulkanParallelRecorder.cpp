@@ -0,0 +1,108 @@
+#include "VulkanParallelRecorder.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanLogicalDevice.h"
+#include "VulkanStructs.h"
+#include "Thread/ThreadPool.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanParallelRecorder::VulkanParallelRecorder(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
+		ThreadPool* threadPool, uint32_t frameCount) {
+		_logicalDevice = logicalDevice;
+		_threadPool = threadPool;
+		_workerCount = threadPool->getThreadCount();
+
+		QueueFamilyIndices* queueFamilyIndices = physicalDevice->getQueueFamilyIndices();
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		_commandPools.resize(frameCount * _workerCount);
+		_commandBuffers.resize(frameCount * _workerCount);
+
+		for (size_t i = 0; i < _commandPools.size(); i++) {
+			vk::CommandPoolCreateInfo poolInfo = vk::CommandPoolCreateInfo()
+				.setQueueFamilyIndex(queueFamilyIndices->graphicsFamily)
+				.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+
+			if (vkDevice->createCommandPool(&poolInfo, nullptr, &_commandPools[i]) != vk::Result::eSuccess) {
+				throw std::runtime_error("failed to create command pool!");
+			}
+
+			vk::CommandBufferAllocateInfo allocInfo = vk::CommandBufferAllocateInfo()
+				.setCommandPool(_commandPools[i])
+				.setLevel(vk::CommandBufferLevel::eSecondary)
+				.setCommandBufferCount(1);
+
+			if (vkDevice->allocateCommandBuffers(&allocInfo, &_commandBuffers[i]) != vk::Result::eSuccess) {
+				throw std::runtime_error("failed to allocate command buffers!");
+			}
+		}
+	}
+
+	VulkanParallelRecorder::~VulkanParallelRecorder() {
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		// destroying a pool frees the buffers allocated from it
+		for (size_t i = 0; i < _commandPools.size(); i++) {
+			vkDevice->destroyCommandPool(_commandPools[i], nullptr);
+		}
+	}
+
+	bool VulkanParallelRecorder::shouldRecordInParallel(uint32_t itemCount) {
+		return getChunkCount(itemCount) > 1;
+	}
+
+	std::vector<vk::CommandBuffer> VulkanParallelRecorder::record(uint32_t frameIndex, vk::RenderPass renderPass, vk::Framebuffer framebuffer,
+		uint32_t itemCount, const RecordRangeFunc& recordRange) {
+		uint32_t chunkCount = getChunkCount(itemCount);
+		uint32_t itemsPerChunk = (itemCount + chunkCount - 1) / chunkCount;
+
+		std::vector<vk::CommandBuffer> secondaryBuffers;
+		std::vector<std::future<void>> results;
+
+		for (uint32_t chunk = 0; chunk < chunkCount; chunk++) {
+			uint32_t first = chunk * itemsPerChunk;
+			uint32_t count = (std::min)(itemsPerChunk, itemCount - first);
+			if (count == 0) {
+				break;
+			}
+
+			size_t slot = frameIndex * _workerCount + chunk;
+			vk::CommandPool commandPool = _commandPools[slot];
+			vk::CommandBuffer* commandBuffer = &_commandBuffers[slot];
+			secondaryBuffers.push_back(*commandBuffer);
+
+			results.push_back(_threadPool->enqueue([this, commandPool, commandBuffer, renderPass, framebuffer, first, count, &recordRange]() {
+				// the frame fence has signaled, so nothing from this pool is still in flight
+				_logicalDevice->getObject()->resetCommandPool(commandPool, vk::CommandPoolResetFlags());
+
+				vk::CommandBufferInheritanceInfo inheritanceInfo = vk::CommandBufferInheritanceInfo()
+					.setRenderPass(renderPass)
+					.setSubpass(0)
+					.setFramebuffer(framebuffer);
+
+				vk::CommandBufferBeginInfo beginInfo = vk::CommandBufferBeginInfo()
+					.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+					.setPInheritanceInfo(&inheritanceInfo);
+
+				commandBuffer->begin(&beginInfo);
+				recordRange(commandBuffer, first, count);
+				commandBuffer->end();
+			}));
+		}
+
+		// let every chunk finish before rethrowing, the tasks reference recordRange
+		for (auto& result : results) {
+			result.wait();
+		}
+		for (auto& result : results) {
+			result.get();
+		}
+
+		return secondaryBuffers;
+	}
+
+	uint32_t VulkanParallelRecorder::getChunkCount(uint32_t itemCount) {
+		uint32_t chunkCount = itemCount / MIN_ITEMS_PER_THREAD;
+		return (std::max)(1u, (std::min)(chunkCount, _workerCount));
+	}
+}
@@ -0,0 +1,48 @@
+#ifndef VulkanParallelRecorder_h_
+#define VulkanParallelRecorder_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <functional>
+#include <vector>
+
+namespace litter {
+	class VulkanPhysicalDevice;
+	class VulkanLogicalDevice;
+	class ThreadPool;
+
+	// splits a frame's draws into secondary command buffers recorded on the worker pool.
+	// every worker owns a transient command pool per frame slot, so recording needs no locking
+	// and the whole pool is reset at once when its slot comes round again.
+	class VulkanParallelRecorder : public BaseObject {
+	public:
+		typedef std::function<void(vk::CommandBuffer* commandBuffer, uint32_t first, uint32_t count)> RecordRangeFunc;
+
+		VulkanParallelRecorder(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
+			ThreadPool* threadPool, uint32_t frameCount);
+		~VulkanParallelRecorder();
+
+		// below this many items per thread the cost of the hand-off outweighs the recording itself
+		bool shouldRecordInParallel(uint32_t itemCount);
+
+		// returns the secondary buffers in item order, ready for executeCommands inside the render pass
+		std::vector<vk::CommandBuffer> record(uint32_t frameIndex, vk::RenderPass renderPass, vk::Framebuffer framebuffer,
+			uint32_t itemCount, const RecordRangeFunc& recordRange);
+
+	private:
+		uint32_t getChunkCount(uint32_t itemCount);
+
+	private:
+		static const uint32_t MIN_ITEMS_PER_THREAD = 256;
+
+		uint32_t _workerCount;
+		// indexed [frame * _workerCount + worker]
+		std::vector<vk::CommandPool> _commandPools;
+		std::vector<vk::CommandBuffer> _commandBuffers;
+
+		VulkanLogicalDevice* _logicalDevice;
+		ThreadPool* _threadPool;
+	};
+}
+
+#endif // !VulkanParallelRecorder_h_
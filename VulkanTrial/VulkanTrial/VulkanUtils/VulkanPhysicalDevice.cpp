@@ -7,7 +7,7 @@ namespace litter {
 	VulkanPhysicalDevice::VulkanPhysicalDevice(VulkanInstance* instance, VulkanSurface* surface) {
 		_surface = surface;
 
-		_physicalDevice = VK_NULL_HANDLE;
+		_physicalDevice = vk::PhysicalDevice();
 		vk::Instance* vkInstance = instance->getObject();
 
 		uint32_t deviceCount = 0;
@@ -27,13 +27,16 @@ namespace litter {
 				continue;
 			}
 
-			if (!checkDeviceExtensionSupport(device)) {
-				continue;
-			}
+			SwapChainSupportDetails swapChainSupport;
+			if (!isHeadless()) {
+				if (!checkDeviceExtensionSupport(device)) {
+					continue;
+				}
 
-			SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device, surface);
-			if (swapChainSupport.formats.empty() || swapChainSupport.presentModes.empty()) {
-				continue;
+				swapChainSupport = querySwapChainSupport(device, surface);
+				if (swapChainSupport.formats.empty() || swapChainSupport.presentModes.empty()) {
+					continue;
+				}
 			}
 
 			if (isDeviceSuitable(device)) {
@@ -44,7 +47,7 @@ namespace litter {
 			}
 		}
 
-		if (_physicalDevice == VK_NULL_HANDLE) {
+		if (!_physicalDevice) {
 			throw std::runtime_error("failed to find a suitable GPU!");
 		}
 
@@ -70,21 +73,21 @@ namespace litter {
 	}
 
 	vk::PhysicalDevice* VulkanPhysicalDevice::getObject() {
-		if (_physicalDevice == VK_NULL_HANDLE) {
+		if (!_physicalDevice) {
 			return nullptr;
 		}
 		return &_physicalDevice;
 	}
 
 	QueueFamilyIndices* VulkanPhysicalDevice::getQueueFamilyIndices() {
-		if (_physicalDevice == VK_NULL_HANDLE) {
+		if (!_physicalDevice) {
 			return nullptr;
 		}
 		return &_queueFamilyIndices;
 	}
 
 	SwapChainSupportDetails* VulkanPhysicalDevice::getSwapChainSupport() {
-		if (_physicalDevice == VK_NULL_HANDLE) {
+		if (!_physicalDevice || isHeadless()) {
 			return nullptr;
 		}
 		// todo: do not query again
@@ -96,12 +99,32 @@ namespace litter {
 		return &_depthFormat;
 	}
 
+	bool VulkanPhysicalDevice::isHeadless() {
+		return _surface == nullptr;
+	}
+
+	bool VulkanPhysicalDevice::isExtensionSupported(const char* name) {
+		uint32_t extensionCount = 0;
+		_physicalDevice.enumerateDeviceExtensionProperties(nullptr, &extensionCount, nullptr);
+
+		std::vector<vk::ExtensionProperties> availableExtensions(extensionCount);
+		_physicalDevice.enumerateDeviceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
+
+		for (const auto& extension : availableExtensions) {
+			if (strcmp(extension.extensionName, name) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	bool VulkanPhysicalDevice::isDeviceSuitable(vk::PhysicalDevice device)
 	{
 		vk::PhysicalDeviceFeatures supportedFeatures;
 		device.getFeatures(&supportedFeatures);
 
-		return supportedFeatures.samplerAnisotropy;
+		// the texture table is indexed per draw from a push constant
+		return supportedFeatures.samplerAnisotropy && supportedFeatures.shaderSampledImageArrayDynamicIndexing;
 	}
 
 	QueueFamilyIndices VulkanPhysicalDevice::findQueueFamilies(const vk::PhysicalDevice& device, VulkanSurface* surface) {
@@ -119,8 +142,13 @@ namespace litter {
 				indices.graphicsFamily = i;
 			}
 
+			// nothing is ever presented in headless mode, the graphics queue stands in for the present queue
 			VkBool32 presentSupport = false;
-			device.getSurfaceSupportKHR(i, *surface->getObject(), &presentSupport);
+			if (surface == nullptr) {
+				presentSupport = queueFamily.queueFlags & vk::QueueFlagBits::eGraphics ? VK_TRUE : VK_FALSE;
+			} else {
+				device.getSurfaceSupportKHR(i, *surface->getObject(), &presentSupport);
+			}
 
 			if (queueFamily.queueCount > 0 && presentSupport) {
 				indices.presentFamily = i;
@@ -133,6 +161,30 @@ namespace litter {
 			i++;
 		}
 
+		if (indices.graphicsFamily < 0) {
+			return indices;
+		}
+
+		// a family with transfer but neither graphics nor compute is usually a dma engine that copies alongside rendering.
+		// compute families can copy as well, and a second graphics queue at least keeps uploads off the frame's queue
+		for (size_t family = 0; family < queueFamilies.size() && indices.transferFamily < 0; family++) {
+			vk::QueueFlags flags = queueFamilies[family].queueFlags;
+			if (queueFamilies[family].queueCount > 0 && (flags & vk::QueueFlagBits::eTransfer) &&
+				!(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+				indices.transferFamily = static_cast<int>(family);
+			}
+		}
+		for (size_t family = 0; family < queueFamilies.size() && indices.transferFamily < 0; family++) {
+			vk::QueueFlags flags = queueFamilies[family].queueFlags;
+			if (queueFamilies[family].queueCount > 0 && (flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics)) {
+				indices.transferFamily = static_cast<int>(family);
+			}
+		}
+		if (indices.transferFamily < 0) {
+			indices.transferFamily = indices.graphicsFamily;
+			indices.transferQueueIndex = queueFamilies[indices.graphicsFamily].queueCount > 1 ? 1 : 0;
+		}
+
 		return indices;
 	}
 
@@ -11,6 +11,7 @@ namespace litter {
 
 	class VulkanPhysicalDevice : public BaseObject {
 	public:
+		// a null surface selects headless mode: no presentation support or swapchain extension is required
 		VulkanPhysicalDevice(VulkanInstance* instance, VulkanSurface* surface);
 		~VulkanPhysicalDevice();
 
@@ -18,6 +19,9 @@ namespace litter {
 		QueueFamilyIndices* getQueueFamilyIndices();
 		SwapChainSupportDetails* getSwapChainSupport();
 		vk::Format* getDepthFormat();
+		bool isHeadless();
+		// for optional extensions, the required ones are checked when the device is picked
+		bool isExtensionSupported(const char* name);
 	private:
 		bool isDeviceSuitable(vk::PhysicalDevice device);
 		QueueFamilyIndices findQueueFamilies(const vk::PhysicalDevice& device, VulkanSurface* surface);
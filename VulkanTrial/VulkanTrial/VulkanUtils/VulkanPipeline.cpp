@@ -1,29 +1,33 @@
 #include "VulkanPipeline.h"
 #include "VulkanLogicalDevice.h"
 #include "VulkanRenderPass.h"
-#include "VulkanSwapChain.h"
 #include "VulkanDescriptorSetLayout.h"
-#include "File/File.h"
+#include "VulkanDescriptorSetLayoutCache.h"
+#include "VulkanPipelineCache.h"
+#include "VulkanShaderManager.h"
 
 namespace litter {
-	VulkanPipeline::VulkanPipeline(VulkanLogicalDevice* logicalDevice,
-		VulkanSwapChain* swapChain, VulkanDescriptorSetLayout* descriptorSetLayout, VulkanRenderPass* renderPass) {
+	VulkanPipeline::VulkanPipeline(VulkanLogicalDevice* logicalDevice, VulkanShaderManager* shaderManager,
+		VulkanDescriptorSetLayoutCache* layoutCache, VulkanRenderPass* renderPass) {
 		_logicalDevice = logicalDevice;
+		_shaderManager = shaderManager;
+		_vertexShaderPath = "shaders/shader.vert";
+		_fragmentShaderPath = "shaders/shader.frag";
 
-		init(swapChain, descriptorSetLayout, renderPass);
+		init(layoutCache, renderPass);
 	}
 
 	VulkanPipeline::~VulkanPipeline() {
 		cleanup();
 	}
 
-	void VulkanPipeline::init(VulkanSwapChain* swapChain, VulkanDescriptorSetLayout* descriptorSetLayout, VulkanRenderPass* renderPass) {
+	void VulkanPipeline::init(VulkanDescriptorSetLayoutCache* layoutCache, VulkanRenderPass* renderPass) {
 		// todo: remove shader stuffs
-		auto vertShaderCode = File::readFile("shaders/vert.spv");
-		auto fragShaderCode = File::readFile("shaders/frag.spv");
-
-		vk::ShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-		vk::ShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+		// modules are owned and cached by the shader manager, they outlive this pipeline
+		VulkanShader* vertShader = _shaderManager->getShader(_vertexShaderPath, VulkanShaderManager::Defines());
+		VulkanShader* fragShader = _shaderManager->getShader(_fragmentShaderPath, VulkanShaderManager::Defines());
+		vk::ShaderModule vertShaderModule = vertShader->module;
+		vk::ShaderModule fragShaderModule = fragShader->module;
 
 		vk::PipelineShaderStageCreateInfo vertShaderStageInfo = vk::PipelineShaderStageCreateInfo()
 			.setStage(vk::ShaderStageFlagBits::eVertex)
@@ -41,23 +45,24 @@ namespace litter {
 			.setVertexBindingDescriptionCount(0)
 			.setVertexAttributeDescriptionCount(0);
 
+		// vertices are interleaved in one buffer, attributes packed tightly in location order
+		const std::vector<ShaderVertexInput>& vertexInputs = vertShader->reflection.getVertexInputs();
+		std::vector<vk::VertexInputAttributeDescription> attributeDescriptions(vertexInputs.size());
+		uint32_t stride = 0;
+		for (size_t i = 0; i < vertexInputs.size(); i++) {
+			attributeDescriptions[i].binding = 0;
+			attributeDescriptions[i].location = vertexInputs[i].location;
+			attributeDescriptions[i].format = vertexInputs[i].format;
+			attributeDescriptions[i].offset = stride;
+			stride += vertexInputs[i].size;
+		}
+
 		vk::VertexInputBindingDescription bindingDescription = {};
 		bindingDescription.binding = 0;
-		bindingDescription.stride = sizeof(float) * 5;
+		bindingDescription.stride = stride;
 		bindingDescription.inputRate = vk::VertexInputRate::eVertex;
 
-		std::array<vk::VertexInputAttributeDescription, 2> attributeDescriptions = {};
-		attributeDescriptions[0].binding = 0;
-		attributeDescriptions[0].location = 0;
-		attributeDescriptions[0].format = vk::Format::eR32G32B32Sfloat;
-		attributeDescriptions[0].offset = 0;
-
-		attributeDescriptions[1].binding = 0;
-		attributeDescriptions[1].location = 1;
-		attributeDescriptions[1].format = vk::Format::eR32G32B32Sfloat;
-		attributeDescriptions[1].offset = sizeof(float) * 3;
-
-		vertexInputInfo.vertexBindingDescriptionCount = 1;
+		vertexInputInfo.vertexBindingDescriptionCount = vertexInputs.empty() ? 0 : 1;
 		vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
 		vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
 		vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
@@ -66,25 +71,21 @@ namespace litter {
 			.setTopology(vk::PrimitiveTopology::eTriangleList)
 			.setPrimitiveRestartEnable(VK_FALSE);
 
-		vk::Viewport viewport = vk::Viewport()
-			.setX(0.0f)
-			.setY(0.0f)
-			.setWidth((float)swapChain->getExtentWidth())
-			.setHeight((float)swapChain->getExtentHeight())
-			.setMinDepth(0.0f)
-			.setMaxDepth(1.0f);
-
-		vk::Rect2D scissor = vk::Rect2D()
-			.setOffset(vk::Offset2D()
-				.setX(0)
-				.setY(0))
-			.setExtent(*swapChain->getExtent());
-
+		// only the counts are baked in, the rectangles come from setViewport/setScissor
 		vk::PipelineViewportStateCreateInfo viewportState = vk::PipelineViewportStateCreateInfo()
 			.setViewportCount(1)
-			.setPViewports(&viewport)
+			.setPViewports(nullptr)
 			.setScissorCount(1)
-			.setPScissors(&scissor);
+			.setPScissors(nullptr);
+
+		std::array<vk::DynamicState, 2> dynamicStates = {
+			vk::DynamicState::eViewport,
+			vk::DynamicState::eScissor
+		};
+
+		vk::PipelineDynamicStateCreateInfo dynamicState = vk::PipelineDynamicStateCreateInfo()
+			.setDynamicStateCount(static_cast<uint32_t>(dynamicStates.size()))
+			.setPDynamicStates(dynamicStates.data());
 
 		vk::PipelineRasterizationStateCreateInfo rasterizer = vk::PipelineRasterizationStateCreateInfo()
 			.setDepthClampEnable(VK_FALSE)
@@ -120,9 +121,18 @@ namespace litter {
 		colorBlending.blendConstants[2] = 0.0f;
 		colorBlending.blendConstants[3] = 0.0f;
 
+		createLayouts(layoutCache, { vertShader, fragShader });
+
+		std::vector<vk::DescriptorSetLayout> setLayouts(_setLayouts.size());
+		for (size_t i = 0; i < _setLayouts.size(); i++) {
+			setLayouts[i] = *_setLayouts[i]->getObject();
+		}
+
 		vk::PipelineLayoutCreateInfo pipelineLayoutInfo = vk::PipelineLayoutCreateInfo()
-			.setSetLayoutCount(1)
-			.setPSetLayouts(descriptorSetLayout->getObject());
+			.setSetLayoutCount(static_cast<uint32_t>(setLayouts.size()))
+			.setPSetLayouts(setLayouts.data())
+			.setPushConstantRangeCount(_pushConstantRange.size > 0 ? 1 : 0)
+			.setPPushConstantRanges(&_pushConstantRange);
 
 		vk::Device* vkDevice = _logicalDevice->getObject();
 		if (vkDevice->createPipelineLayout(&pipelineLayoutInfo, nullptr, &_pipelineLayout) != vk::Result::eSuccess)
@@ -142,16 +152,14 @@ namespace litter {
 		pipelineInfo.layout = _pipelineLayout;
 		pipelineInfo.renderPass = *renderPass->getObject();
 		pipelineInfo.subpass = 0;
-		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+		pipelineInfo.basePipelineHandle = vk::Pipeline();
 		pipelineInfo.pDepthStencilState = &depthStencil;
+		pipelineInfo.pDynamicState = &dynamicState;
 
-		if (vkDevice->createGraphicsPipelines(VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_pipeline) != vk::Result::eSuccess)
+		if (vkDevice->createGraphicsPipelines(*_logicalDevice->getPipelineCache()->getObject(), 1, &pipelineInfo, nullptr, &_pipeline) != vk::Result::eSuccess)
 		{
 			throw std::runtime_error("failed to create graphics pipeline!");
 		}
-
-		vkDevice->destroyShaderModule(fragShaderModule, nullptr);
-		vkDevice->destroyShaderModule(vertShaderModule, nullptr);
 	}
 
 	void VulkanPipeline::cleanup() {
@@ -168,22 +176,87 @@ namespace litter {
 		return &_pipelineLayout;
 	}
 
-	vk::ShaderModule VulkanPipeline::createShaderModule(const std::vector<char>& code)
-	{
-		vk::ShaderModuleCreateInfo createInfo = vk::ShaderModuleCreateInfo()
-			.setCodeSize(code.size());
+	VulkanDescriptorSetLayout* VulkanPipeline::getDescriptorSetLayout(uint32_t set) {
+		return _setLayouts[set];
+	}
+
+	uint32_t VulkanPipeline::getDescriptorSetLayoutCount() {
+		return static_cast<uint32_t>(_setLayouts.size());
+	}
 
-		std::vector<uint32_t> codeAligned(code.size() / 4 + 1);
-		memcpy(codeAligned.data(), code.data(), code.size());
+	const vk::PushConstantRange& VulkanPipeline::getPushConstantRange() {
+		return _pushConstantRange;
+	}
 
-		createInfo.pCode = codeAligned.data();
+	bool VulkanPipeline::isLayoutCompatible(VulkanPipeline* other) {
+		return _setLayouts == other->_setLayouts && _pushConstantRange == other->_pushConstantRange;
+	}
 
-		vk::ShaderModule shaderModule;
-		if (_logicalDevice->getObject()->createShaderModule(&createInfo, nullptr, &shaderModule) != vk::Result::eSuccess)
-		{
-			throw std::runtime_error("failed to create shader module!");
+	std::vector<std::string> VulkanPipeline::getShaderPaths() {
+		return { _vertexShaderPath, _fragmentShaderPath };
+	}
+
+	bool VulkanPipeline::usesShader(const std::string& path) {
+		return path == _vertexShaderPath || path == _fragmentShaderPath;
+	}
+
+	void VulkanPipeline::createLayouts(VulkanDescriptorSetLayoutCache* layoutCache, const std::vector<VulkanShader*>& shaders) {
+		std::vector<std::vector<vk::DescriptorSetLayoutBinding>> setBindings;
+		_pushConstantRange = vk::PushConstantRange();
+
+		for (VulkanShader* shader : shaders) {
+			vk::ShaderStageFlagBits stage = shader->reflection.getStage();
+
+			for (const ShaderBinding& shaderBinding : shader->reflection.getBindings()) {
+				// uniforms are all fed from the uniform ring, so every uniform buffer is bound with a dynamic offset
+				vk::DescriptorType type = shaderBinding.type;
+				if (type == vk::DescriptorType::eUniformBuffer) {
+					type = vk::DescriptorType::eUniformBufferDynamic;
+				}
+
+				if (setBindings.size() <= shaderBinding.set) {
+					setBindings.resize(shaderBinding.set + 1);
+				}
+				std::vector<vk::DescriptorSetLayoutBinding>& bindings = setBindings[shaderBinding.set];
+
+				// a binding used by several stages becomes one entry visible to all of them
+				auto found = std::find_if(bindings.begin(), bindings.end(), [&shaderBinding](const vk::DescriptorSetLayoutBinding& binding) {
+					return binding.binding == shaderBinding.binding;
+				});
+				if (found != bindings.end()) {
+					if (found->descriptorType != type || found->descriptorCount != shaderBinding.count) {
+						throw std::runtime_error("shader stages disagree on a descriptor binding!");
+					}
+					found->stageFlags |= stage;
+					continue;
+				}
+
+				bindings.push_back(vk::DescriptorSetLayoutBinding()
+					.setBinding(shaderBinding.binding)
+					.setDescriptorType(type)
+					.setDescriptorCount(shaderBinding.count)
+					.setStageFlags(stage)
+					.setPImmutableSamplers(nullptr));
+			}
+
+			// stages share one range, so a draw pushes its block once with every stage that reads it.
+			// a stage declaring a smaller block than another only reads the front of it
+			uint32_t pushConstantSize = shader->reflection.getPushConstantSize();
+			if (pushConstantSize > 0) {
+				_pushConstantRange.stageFlags |= stage;
+				_pushConstantRange.size = (std::max)(_pushConstantRange.size, pushConstantSize);
+			}
 		}
 
-		return shaderModule;
+		// sets skipped by the shaders still need a layout, an empty one is shared by all of them
+		_setLayouts.resize(setBindings.size());
+		for (size_t i = 0; i < setBindings.size(); i++) {
+			_setLayouts[i] = layoutCache->getLayout(setBindings[i]);
+
+			// a draw item carries a single dynamic offset
+			if (_setLayouts[i]->getDynamicOffsetCount() > 1) {
+				throw std::runtime_error("only one dynamic uniform buffer per descriptor set is supported!");
+			}
+		}
 	}
 }
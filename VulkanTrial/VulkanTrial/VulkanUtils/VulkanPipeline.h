@@ -3,30 +3,50 @@
 
 #include "Base/BaseObject.h"
 #include "VulkanHeader.h"
+#include <string>
 
 namespace litter {
 	class VulkanLogicalDevice;
 	class VulkanRenderPass;
-	class VulkanSwapChain;
 	class VulkanDescriptorSetLayout;
+	class VulkanDescriptorSetLayoutCache;
+	class VulkanShaderManager;
+	struct VulkanShader;
 
 	class VulkanPipeline : public BaseObject {
 	public:
-		VulkanPipeline(VulkanLogicalDevice* logicalDevice, VulkanSwapChain* swapChain, VulkanDescriptorSetLayout* descriptorSetLayout, VulkanRenderPass* renderPass);
+		// viewport and scissor are dynamic state set at record time, so the pipeline does not depend on the window size
+		// descriptor set layouts, push constant ranges and vertex attributes are reflected from the shaders
+		VulkanPipeline(VulkanLogicalDevice* logicalDevice, VulkanShaderManager* shaderManager,
+			VulkanDescriptorSetLayoutCache* layoutCache, VulkanRenderPass* renderPass);
 		~VulkanPipeline();
-		void init(VulkanSwapChain* swapChain, VulkanDescriptorSetLayout* descriptorSetLayout, VulkanRenderPass* renderPass);
+		void init(VulkanDescriptorSetLayoutCache* layoutCache, VulkanRenderPass* renderPass);
 		void cleanup();
 
 		vk::Pipeline* getObject();
 		vk::PipelineLayout* getPiprlineLayout();
+		VulkanDescriptorSetLayout* getDescriptorSetLayout(uint32_t set);
+		uint32_t getDescriptorSetLayoutCount();
+		// a single range over every stage that declares push constants, its size is 0 when none does
+		const vk::PushConstantRange& getPushConstantRange();
+		// true when descriptor sets and push constants of one pipeline can be used with the other
+		bool isLayoutCompatible(VulkanPipeline* other);
+		std::vector<std::string> getShaderPaths();
+		bool usesShader(const std::string& path);
 	private:
-		vk::ShaderModule createShaderModule(const std::vector<char>& code);
+		void createLayouts(VulkanDescriptorSetLayoutCache* layoutCache, const std::vector<VulkanShader*>& shaders);
 
 	private:
 		vk::Pipeline _pipeline;
 		vk::PipelineLayout _pipelineLayout;
+		// owned by the layout cache
+		std::vector<VulkanDescriptorSetLayout*> _setLayouts;
+		vk::PushConstantRange _pushConstantRange;
+		std::string _vertexShaderPath;
+		std::string _fragmentShaderPath;
 
 		VulkanLogicalDevice* _logicalDevice;
+		VulkanShaderManager* _shaderManager;
 	};
 }
 
@@ -0,0 +1,78 @@
+#include "VulkanPipelineCache.h"
+#include "VulkanPhysicalDevice.h"
+#include "File/File.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanPipelineCache::VulkanPipelineCache(vk::Device* device, VulkanPhysicalDevice* physicalDevice, const std::string& path) {
+		_device = device;
+		_path = path;
+
+		physicalDevice->getObject()->getProperties(&_properties);
+
+		std::vector<char> data;
+		if (File::exists(_path)) {
+			data = File::readFile(_path);
+			if (!isCompatible(data)) {
+				std::cout << "pipeline cache " << _path << " was written by another device or driver, ignoring it." << std::endl;
+				data.clear();
+			}
+		}
+
+		vk::PipelineCacheCreateInfo createInfo = vk::PipelineCacheCreateInfo()
+			.setInitialDataSize(data.size())
+			.setPInitialData(data.empty() ? nullptr : data.data());
+
+		if (_device->createPipelineCache(&createInfo, nullptr, &_pipelineCache) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create pipeline cache!");
+		}
+	}
+
+	VulkanPipelineCache::~VulkanPipelineCache() {
+		_device->destroyPipelineCache(_pipelineCache, nullptr);
+	}
+
+	void VulkanPipelineCache::save() {
+		size_t dataSize = 0;
+		if (_device->getPipelineCacheData(_pipelineCache, &dataSize, nullptr) != vk::Result::eSuccess || dataSize == 0) {
+			return;
+		}
+
+		std::vector<char> data(dataSize);
+		if (_device->getPipelineCacheData(_pipelineCache, &dataSize, data.data()) != vk::Result::eSuccess) {
+			return;
+		}
+		data.resize(dataSize);
+
+		// losing the cache only costs startup time, it is not worth failing shutdown over
+		if (!File::writeFile(_path, data)) {
+			std::cout << "failed to write pipeline cache " << _path << "." << std::endl;
+		}
+	}
+
+	vk::PipelineCache* VulkanPipelineCache::getObject() {
+		return &_pipelineCache;
+	}
+
+	bool VulkanPipelineCache::isCompatible(const std::vector<char>& data) {
+		// header layout of VK_PIPELINE_CACHE_HEADER_VERSION_ONE:
+		// length, version, vendorID, deviceID as uint32_t, then the pipelineCacheUUID
+		const size_t headerSize = sizeof(uint32_t) * 4 + VK_UUID_SIZE;
+		if (data.size() < headerSize) {
+			return false;
+		}
+
+		uint32_t header[4];
+		memcpy(header, data.data(), sizeof(header));
+
+		if (header[0] < headerSize || header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) {
+			return false;
+		}
+
+		if (header[2] != _properties.vendorID || header[3] != _properties.deviceID) {
+			return false;
+		}
+
+		return memcmp(data.data() + sizeof(header), _properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef VulkanPipelineCache_h_
+#define VulkanPipelineCache_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <string>
+
+namespace litter {
+	class VulkanPhysicalDevice;
+
+	// keeps compiled pipelines across runs. the blob on disk is only fed back to the driver when
+	// its header matches this vendor, device and driver build, anything else starts an empty cache
+	class VulkanPipelineCache : public BaseObject {
+	public:
+		VulkanPipelineCache(vk::Device* device, VulkanPhysicalDevice* physicalDevice, const std::string& path);
+		~VulkanPipelineCache();
+
+		// replaces the file in one step, a crash mid-write leaves the previous cache intact
+		void save();
+
+		vk::PipelineCache* getObject();
+	private:
+		bool isCompatible(const std::vector<char>& data);
+
+	private:
+		vk::PipelineCache _pipelineCache;
+		std::string _path;
+		vk::PhysicalDeviceProperties _properties;
+
+		vk::Device* _device;
+	};
+}
+
+#endif // !VulkanPipelineCache_h_
@@ -0,0 +1,230 @@
+#include "VulkanProfiler.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanLogicalDevice.h"
+#include "VulkanCommandPool.h"
+#include "VulkanSingleTimeCommand.h"
+#include "StdC.h"
+#include <atomic>
+
+namespace litter {
+	namespace {
+		// tid 0 is the gpu track
+		std::atomic<uint32_t> nextThreadId(1);
+	}
+
+	VulkanProfiler::VulkanProfiler(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
+		VulkanCommandPool* commandPool, uint32_t frameCount) {
+		_logicalDevice = logicalDevice;
+		_frameCount = frameCount;
+		_singleTimeQuery = frameCount * QUERIES_PER_FRAME;
+		_gpuOffsetNs = 0;
+		_startTime = std::chrono::steady_clock::now();
+
+		_frameZones.resize(frameCount);
+		_frameQueryCounts.resize(frameCount, 0);
+
+		vk::PhysicalDeviceProperties properties;
+		physicalDevice->getObject()->getProperties(&properties);
+		_timestampPeriod = properties.limits.timestampPeriod;
+
+		uint32_t queueFamilyCount = 0;
+		physicalDevice->getObject()->getQueueFamilyProperties(&queueFamilyCount, nullptr);
+		std::vector<vk::QueueFamilyProperties> queueFamilies(queueFamilyCount);
+		physicalDevice->getObject()->getQueueFamilyProperties(&queueFamilyCount, queueFamilies.data());
+
+		uint32_t validBits = queueFamilies[physicalDevice->getQueueFamilyIndices()->graphicsFamily].timestampValidBits;
+		_gpuEnabled = validBits > 0;
+		_timestampMask = validBits >= 64 ? ~0ULL : ((1ULL << validBits) - 1);
+
+		if (!_gpuEnabled) {
+			std::cerr << "profiler: graphics queue has no timestamp support, recording cpu zones only" << std::endl;
+			return;
+		}
+
+		// one region per frame slot plus a begin/end pair for single time commands
+		vk::QueryPoolCreateInfo poolInfo = vk::QueryPoolCreateInfo()
+			.setQueryType(vk::QueryType::eTimestamp)
+			.setQueryCount(_singleTimeQuery + 2);
+
+		if (_logicalDevice->getObject()->createQueryPool(&poolInfo, nullptr, &_queryPool) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create timestamp query pool!");
+		}
+
+		calibrate(commandPool);
+	}
+
+	VulkanProfiler::~VulkanProfiler() {
+		if (_gpuEnabled) {
+			_logicalDevice->getObject()->destroyQueryPool(_queryPool, nullptr);
+		}
+	}
+
+	void VulkanProfiler::beginFrame(uint32_t frameIndex) {
+		std::vector<GpuZone>& zones = _frameZones[frameIndex];
+		uint32_t queryCount = _frameQueryCounts[frameIndex];
+		if (!_gpuEnabled || queryCount == 0) {
+			return;
+		}
+
+		std::vector<uint64_t> timestamps(queryCount);
+		vk::Result result = _logicalDevice->getObject()->getQueryPoolResults(_queryPool, frameIndex * QUERIES_PER_FRAME, queryCount,
+			timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+
+		// never wait here, a slot whose results are somehow not ready yet just loses its gpu zones
+		if (result == vk::Result::eSuccess) {
+			std::lock_guard<std::mutex> lock(_eventsMutex);
+			for (const auto& zone : zones) {
+				uint64_t beginUs = gpuTicksToCpuUs(timestamps[zone.beginQuery]);
+				uint64_t endUs = gpuTicksToCpuUs(timestamps[zone.endQuery]);
+
+				TraceEvent event = { zone.name, "gpu", beginUs, endUs > beginUs ? endUs - beginUs : 0, 0 };
+				_events.push_back(event);
+			}
+		}
+
+		zones.clear();
+		_frameQueryCounts[frameIndex] = 0;
+	}
+
+	void VulkanProfiler::resetQueries(vk::CommandBuffer* commandBuffer, uint32_t frameIndex) {
+		if (!_gpuEnabled) {
+			return;
+		}
+		commandBuffer->resetQueryPool(_queryPool, frameIndex * QUERIES_PER_FRAME, QUERIES_PER_FRAME);
+	}
+
+	uint32_t VulkanProfiler::beginGpuZone(vk::CommandBuffer* commandBuffer, uint32_t frameIndex, const char* name) {
+		if (!_gpuEnabled || _frameQueryCounts[frameIndex] + 2 > QUERIES_PER_FRAME) {
+			return UINT32_MAX;
+		}
+
+		uint32_t query = _frameQueryCounts[frameIndex];
+		_frameQueryCounts[frameIndex] += 2;
+
+		GpuZone zone = { name, query, query + 1 };
+		_frameZones[frameIndex].push_back(zone);
+
+		commandBuffer->writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, _queryPool, frameIndex * QUERIES_PER_FRAME + query);
+		return static_cast<uint32_t>(_frameZones[frameIndex].size() - 1);
+	}
+
+	void VulkanProfiler::endGpuZone(vk::CommandBuffer* commandBuffer, uint32_t frameIndex, uint32_t zone) {
+		if (zone == UINT32_MAX) {
+			return;
+		}
+
+		uint32_t query = _frameZones[frameIndex][zone].endQuery;
+		commandBuffer->writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, _queryPool, frameIndex * QUERIES_PER_FRAME + query);
+	}
+
+	void VulkanProfiler::beginSingleTimeZone(vk::CommandBuffer* commandBuffer) {
+		if (!_gpuEnabled) {
+			return;
+		}
+		commandBuffer->resetQueryPool(_queryPool, _singleTimeQuery, 2);
+		commandBuffer->writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, _queryPool, _singleTimeQuery);
+	}
+
+	void VulkanProfiler::endSingleTimeZone(vk::CommandBuffer* commandBuffer) {
+		if (!_gpuEnabled) {
+			return;
+		}
+		commandBuffer->writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, _queryPool, _singleTimeQuery + 1);
+	}
+
+	void VulkanProfiler::collectSingleTimeZone() {
+		if (!_gpuEnabled) {
+			return;
+		}
+
+		uint64_t timestamps[2];
+		vk::Result result = _logicalDevice->getObject()->getQueryPoolResults(_queryPool, _singleTimeQuery, 2,
+			sizeof(timestamps), timestamps, sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+		if (result != vk::Result::eSuccess) {
+			return;
+		}
+
+		uint64_t beginUs = gpuTicksToCpuUs(timestamps[0]);
+		uint64_t endUs = gpuTicksToCpuUs(timestamps[1]);
+
+		std::lock_guard<std::mutex> lock(_eventsMutex);
+		TraceEvent event = { "singleTimeCommand", "gpu", beginUs, endUs > beginUs ? endUs - beginUs : 0, 0 };
+		_events.push_back(event);
+	}
+
+	void VulkanProfiler::addCpuZone(const char* name, uint64_t beginUs, uint64_t endUs) {
+		uint32_t threadId = getThreadId();
+
+		std::lock_guard<std::mutex> lock(_eventsMutex);
+		TraceEvent event = { name, "cpu", beginUs, endUs - beginUs, threadId };
+		_events.push_back(event);
+	}
+
+	uint64_t VulkanProfiler::getCpuTimeUs() {
+		auto now = std::chrono::steady_clock::now();
+		return std::chrono::duration_cast<std::chrono::microseconds>(now - _startTime).count();
+	}
+
+	void VulkanProfiler::writeChromeTrace(const std::string& path) {
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open profiler trace file!");
+		}
+
+		std::lock_guard<std::mutex> lock(_eventsMutex);
+
+		// gpu zones go on their own track so they line up under the cpu zones that recorded them
+		file << "{\"traceEvents\":[\n";
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+		for (const auto& event : _events) {
+			file << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+				<< "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.threadId
+				<< ",\"ts\":" << event.beginUs << ",\"dur\":" << event.durationUs << "}";
+		}
+		file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	}
+
+	void VulkanProfiler::calibrate(VulkanCommandPool* commandPool) {
+		// a single blocking round trip at startup to line gpu ticks up with the cpu clock.
+		// the timestamp lands somewhere between the submit and the end of the wait, so take the midpoint
+		uint64_t submitUs = 0;
+		{
+			VulkanSingleTimeCommand singleCmd(_logicalDevice, commandPool);
+			singleCmd.getObject()->resetQueryPool(_queryPool, _singleTimeQuery, 2);
+			singleCmd.getObject()->writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, _queryPool, _singleTimeQuery);
+			// the destructor submits and waits
+			submitUs = getCpuTimeUs();
+		}
+		uint64_t waitedUs = getCpuTimeUs();
+		int64_t cpuNs = static_cast<int64_t>(submitUs + (waitedUs - submitUs) / 2) * 1000;
+
+		uint64_t ticks = 0;
+		_logicalDevice->getObject()->getQueryPoolResults(_queryPool, _singleTimeQuery, 1,
+			sizeof(ticks), &ticks, sizeof(uint64_t), vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+
+		_gpuOffsetNs = cpuNs - static_cast<int64_t>((ticks & _timestampMask) * _timestampPeriod);
+	}
+
+	uint64_t VulkanProfiler::gpuTicksToCpuUs(uint64_t ticks) {
+		int64_t ns = static_cast<int64_t>((ticks & _timestampMask) * _timestampPeriod) + _gpuOffsetNs;
+		return ns > 0 ? static_cast<uint64_t>(ns / 1000) : 0;
+	}
+
+	uint32_t VulkanProfiler::getThreadId() {
+		// handed out in the order threads first record a zone, so no two threads share a track
+		thread_local uint32_t threadId = nextThreadId.fetch_add(1);
+		return threadId;
+	}
+
+	ProfileZone::ProfileZone(VulkanProfiler* profiler, const char* name) {
+		_profiler = profiler;
+		_name = name;
+		_beginUs = profiler != nullptr ? profiler->getCpuTimeUs() : 0;
+	}
+
+	ProfileZone::~ProfileZone() {
+		if (_profiler != nullptr) {
+			_profiler->addCpuZone(_name, _beginUs, _profiler->getCpuTimeUs());
+		}
+	}
+}
@@ -0,0 +1,93 @@
+#ifndef VulkanProfiler_h_
+#define VulkanProfiler_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace litter {
+	class VulkanPhysicalDevice;
+	class VulkanLogicalDevice;
+	class VulkanCommandPool;
+
+	// collects cpu zones and gpu timestamp zones and writes them as a chrome://tracing / perfetto json file.
+	// gpu timestamps of a frame slot are only read back once that slot's fence has signaled again,
+	// so reading them never stalls the pipeline.
+	class VulkanProfiler : public BaseObject {
+	public:
+		VulkanProfiler(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
+			VulkanCommandPool* commandPool, uint32_t frameCount);
+		~VulkanProfiler();
+
+		// call once the slot's fence has signaled, before its command buffer is recorded again
+		void beginFrame(uint32_t frameIndex);
+		void resetQueries(vk::CommandBuffer* commandBuffer, uint32_t frameIndex);
+		uint32_t beginGpuZone(vk::CommandBuffer* commandBuffer, uint32_t frameIndex, const char* name);
+		void endGpuZone(vk::CommandBuffer* commandBuffer, uint32_t frameIndex, uint32_t zone);
+
+		// single time commands already wait for the queue, so their zone is read back straight after
+		void beginSingleTimeZone(vk::CommandBuffer* commandBuffer);
+		void endSingleTimeZone(vk::CommandBuffer* commandBuffer);
+		void collectSingleTimeZone();
+
+		void addCpuZone(const char* name, uint64_t beginUs, uint64_t endUs);
+		uint64_t getCpuTimeUs();
+
+		void writeChromeTrace(const std::string& path);
+
+	private:
+		struct GpuZone {
+			const char* name;
+			uint32_t beginQuery;
+			uint32_t endQuery;
+		};
+
+		struct TraceEvent {
+			const char* name;
+			const char* category;
+			uint64_t beginUs;
+			uint64_t durationUs;
+			uint32_t threadId;
+		};
+
+		void calibrate(VulkanCommandPool* commandPool);
+		uint64_t gpuTicksToCpuUs(uint64_t ticks);
+		uint32_t getThreadId();
+
+	private:
+		static const uint32_t QUERIES_PER_FRAME = 64;
+
+		vk::QueryPool _queryPool;
+		bool _gpuEnabled;
+		uint32_t _frameCount;
+		uint32_t _singleTimeQuery;
+		uint64_t _timestampMask;
+		double _timestampPeriod;
+		int64_t _gpuOffsetNs;
+
+		std::vector<std::vector<GpuZone>> _frameZones;
+		std::vector<uint32_t> _frameQueryCounts;
+
+		std::vector<TraceEvent> _events;
+		std::mutex _eventsMutex;
+		std::chrono::steady_clock::time_point _startTime;
+
+		VulkanLogicalDevice* _logicalDevice;
+	};
+
+	class ProfileZone {
+	public:
+		ProfileZone(VulkanProfiler* profiler, const char* name);
+		~ProfileZone();
+
+	private:
+		VulkanProfiler* _profiler;
+		const char* _name;
+		uint64_t _beginUs;
+	};
+}
+
+#endif // !VulkanProfiler_h_
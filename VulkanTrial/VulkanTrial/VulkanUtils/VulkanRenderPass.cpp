@@ -3,17 +3,17 @@
 #include "VulkanPhysicalDevice.h"
 
 namespace litter {
-	VulkanRenderPass::VulkanRenderPass(VulkanLogicalDevice* logicalDevice, vk::Format* imageFormat, VulkanPhysicalDevice* physicalDevice) {
+	VulkanRenderPass::VulkanRenderPass(VulkanLogicalDevice* logicalDevice, vk::Format* imageFormat, vk::ImageLayout finalLayout, VulkanPhysicalDevice* physicalDevice) {
 		_logicalDevice = logicalDevice;
 
-		init(imageFormat, physicalDevice);
+		init(imageFormat, finalLayout, physicalDevice);
 	}
 
 	VulkanRenderPass::~VulkanRenderPass() {
 		cleanup();
 	}
 
-	void VulkanRenderPass::init(vk::Format* imageFormat, VulkanPhysicalDevice* physicalDevice) {
+	void VulkanRenderPass::init(vk::Format* imageFormat, vk::ImageLayout finalLayout, VulkanPhysicalDevice* physicalDevice) {
 		vk::AttachmentDescription colorAttachment = vk::AttachmentDescription()
 			.setFormat(*imageFormat)
 			.setSamples(vk::SampleCountFlagBits::e1)
@@ -22,7 +22,7 @@ namespace litter {
 			.setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
 			.setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
 			.setInitialLayout(vk::ImageLayout::eUndefined)
-			.setFinalLayout(vk::ImageLayout::ePresentSrcKHR);
+			.setFinalLayout(finalLayout);
 
 		vk::AttachmentDescription depthAttachment = vk::AttachmentDescription()
 			.setFormat(*physicalDevice->getDepthFormat())
@@ -48,12 +48,17 @@ namespace litter {
 			.setPColorAttachments(&colorAttachmentRef)
 			.setPDepthStencilAttachment(&depthAttachmentRef);
 
+		// the depth attachment is shared by every frame in flight, so the previous frame's depth writes
+		// have to finish before this frame clears it. headless images come back with no present or semaphore
+		// in between, so the previous color writes have to be made available here as well
 		vk::SubpassDependency dependency = vk::SubpassDependency()
 			.setSrcSubpass(VK_SUBPASS_EXTERNAL)
 			.setDstSubpass(0)
-			.setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-			.setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput)
-			.setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite);
+			.setSrcStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eLateFragmentTests)
+			.setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite)
+			.setDstStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests)
+			.setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite |
+				vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite);
 
 		std::array<vk::AttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
 
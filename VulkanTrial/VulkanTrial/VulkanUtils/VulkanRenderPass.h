@@ -10,9 +10,9 @@ namespace litter {
 
 	class VulkanRenderPass : public BaseObject {
 	public:
-		VulkanRenderPass(VulkanLogicalDevice* logicalDevice, vk::Format* imageFormat, VulkanPhysicalDevice* physicalDevice);
+		VulkanRenderPass(VulkanLogicalDevice* logicalDevice, vk::Format* imageFormat, vk::ImageLayout finalLayout, VulkanPhysicalDevice* physicalDevice);
 		~VulkanRenderPass();
-		void init(vk::Format* imageFormat, VulkanPhysicalDevice* physicalDevice);
+		void init(vk::Format* imageFormat, vk::ImageLayout finalLayout, VulkanPhysicalDevice* physicalDevice);
 		void cleanup();
 
 		vk::RenderPass* getObject();
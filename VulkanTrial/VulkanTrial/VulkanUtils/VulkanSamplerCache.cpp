@@ -0,0 +1,48 @@
+#include "VulkanSamplerCache.h"
+#include "VulkanPhysicalDevice.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanSamplerCache::VulkanSamplerCache(vk::Device* device, VulkanPhysicalDevice* physicalDevice) {
+		_device = device;
+
+		vk::PhysicalDeviceProperties properties;
+		physicalDevice->getObject()->getProperties(&properties);
+		_maxSamplerCount = properties.limits.maxSamplerAllocationCount;
+		_maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+	}
+
+	VulkanSamplerCache::~VulkanSamplerCache() {
+		for (const CachedSampler& cached : _samplers) {
+			_device->destroySampler(cached.sampler, nullptr);
+		}
+	}
+
+	vk::Sampler VulkanSamplerCache::getSampler(vk::SamplerCreateInfo samplerInfo) {
+		// asking for 16x on a device that stops at 8x is the same sampler as asking for 8x
+		if (samplerInfo.anisotropyEnable) {
+			samplerInfo.maxAnisotropy = (std::min)(samplerInfo.maxAnisotropy, _maxAnisotropy);
+		}
+
+		// textures are created on the render thread, the atlas and others may not be
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		for (const CachedSampler& cached : _samplers) {
+			if (cached.info == samplerInfo) {
+				return cached.sampler;
+			}
+		}
+
+		if (_samplers.size() >= _maxSamplerCount) {
+			throw std::runtime_error("failed to create texture sampler, too many distinct sampler states!");
+		}
+
+		CachedSampler cached;
+		cached.info = samplerInfo;
+		if (_device->createSampler(&samplerInfo, nullptr, &cached.sampler) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create texture sampler!");
+		}
+		_samplers.push_back(cached);
+		return cached.sampler;
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef VulkanSamplerCache_h_
+#define VulkanSamplerCache_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <mutex>
+#include <vector>
+
+namespace litter {
+	class VulkanPhysicalDevice;
+
+	// one sampler per distinct create info, shared by every texture asking for the same state. samplers
+	// live as long as the device, the driver only allows maxSamplerAllocationCount of them at once
+	class VulkanSamplerCache : public BaseObject {
+	public:
+		VulkanSamplerCache(vk::Device* device, VulkanPhysicalDevice* physicalDevice);
+		~VulkanSamplerCache();
+
+		// the whole create info is the key, pNext chains included by pointer. the sampler stays owned by the cache.
+		// anisotropy is clamped to what the device supports before the lookup
+		vk::Sampler getSampler(vk::SamplerCreateInfo samplerInfo);
+
+	private:
+		struct CachedSampler {
+			vk::SamplerCreateInfo info;
+			vk::Sampler sampler;
+		};
+
+		// a few distinct states at most, a linear search is all it takes
+		std::vector<CachedSampler> _samplers;
+		uint32_t _maxSamplerCount;
+		float _maxAnisotropy;
+		std::mutex _mutex;
+
+		vk::Device* _device;
+	};
+}
+
+#endif // !VulkanSamplerCache_h_
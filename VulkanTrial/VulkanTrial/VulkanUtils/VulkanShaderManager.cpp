@@ -0,0 +1,152 @@
+#include "VulkanShaderManager.h"
+#include "VulkanLogicalDevice.h"
+#include "File/File.h"
+#include "Base/Hash.h"
+#include "StdC.h"
+#include <sstream>
+#include <iomanip>
+
+namespace litter {
+	// bump whenever the hashed inputs or the cached file layout change
+	const uint32_t SHADER_CACHE_VERSION = 1;
+	const uint32_t SPIRV_MAGIC = 0x07230203;
+
+	VulkanShaderManager::VulkanShaderManager(VulkanLogicalDevice* logicalDevice, const std::string& cacheDirectory) {
+		_logicalDevice = logicalDevice;
+		_cacheDirectory = cacheDirectory;
+
+		if (!_compiler.IsValid()) {
+			throw std::runtime_error("failed to initialize shader compiler!");
+		}
+
+		File::createDirectory(_cacheDirectory);
+	}
+
+	VulkanShaderManager::~VulkanShaderManager() {
+		vk::Device* vkDevice = _logicalDevice->getObject();
+		for (auto& shader : _shaders) {
+			vkDevice->destroyShaderModule(shader.second->module, nullptr);
+			delete shader.second;
+		}
+	}
+
+	VulkanShader* VulkanShaderManager::getShader(const std::string& path, const Defines& defines) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		shaderc_shader_kind kind = getShaderKind(path);
+		std::vector<char> source = File::readFile(path);
+		uint64_t hash = hashShader(source, kind, defines);
+
+		auto found = _shaders.find(hash);
+		if (found != _shaders.end()) {
+			return found->second;
+		}
+
+		std::ostringstream cachePath;
+		cachePath << _cacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".spv";
+
+		std::vector<uint32_t> spirv;
+		if (!loadCachedSpirv(cachePath.str(), &spirv)) {
+			spirv = compile(path, source, kind, defines);
+
+			std::vector<char> bytes(spirv.size() * sizeof(uint32_t));
+			memcpy(bytes.data(), spirv.data(), bytes.size());
+			if (!File::writeFile(cachePath.str(), bytes)) {
+				std::cout << "failed to write shader cache " << cachePath.str() << "." << std::endl;
+			}
+		}
+
+		// reflected before the module exists, a shader it cannot read leaks nothing
+		VulkanShaderReflection reflection(spirv);
+		VulkanShader* shader = new VulkanShader(createShaderModule(spirv), reflection);
+		_shaders[hash] = shader;
+		return shader;
+	}
+
+	shaderc_shader_kind VulkanShaderManager::getShaderKind(const std::string& path) {
+		size_t dot = path.find_last_of('.');
+		std::string extension = dot == std::string::npos ? "" : path.substr(dot);
+
+		if (extension == ".vert") {
+			return shaderc_glsl_vertex_shader;
+		} else if (extension == ".frag") {
+			return shaderc_glsl_fragment_shader;
+		}
+
+		throw std::runtime_error("unknown shader stage for " + path + "!");
+	}
+
+	uint64_t VulkanShaderManager::hashShader(const std::vector<char>& source, shaderc_shader_kind kind, const Defines& defines) {
+		// every field is terminated so "ab"+"c" and "a"+"bc" do not collide
+		const unsigned char terminator = 0xff;
+		uint64_t hash = Hash::FNV_OFFSET_BASIS;
+		auto mix = [&hash, &terminator](const void* data, size_t size) {
+			hash = Hash::fnv1a(hash, data, size);
+			hash = Hash::fnv1a(hash, &terminator, sizeof(terminator));
+		};
+
+		uint32_t version = SHADER_CACHE_VERSION;
+		uint32_t optimizationLevel = OPTIMIZATION_LEVEL;
+		uint32_t stage = kind;
+		mix(&version, sizeof(version));
+		mix(&optimizationLevel, sizeof(optimizationLevel));
+		mix(&stage, sizeof(stage));
+		for (const auto& define : defines) {
+			mix(define.first.data(), define.first.size());
+			mix(define.second.data(), define.second.size());
+		}
+		mix(source.data(), source.size());
+
+		return hash;
+	}
+
+	std::vector<uint32_t> VulkanShaderManager::compile(const std::string& path, const std::vector<char>& source, shaderc_shader_kind kind,
+		const Defines& defines) {
+		shaderc::CompileOptions options;
+		options.SetOptimizationLevel(OPTIMIZATION_LEVEL);
+		for (const auto& define : defines) {
+			if (define.second.empty()) {
+				options.AddMacroDefinition(define.first);
+			} else {
+				options.AddMacroDefinition(define.first, define.second);
+			}
+		}
+
+		shaderc::SpvCompilationResult result = _compiler.CompileGlslToSpv(source.data(), source.size(), kind, path.c_str(), "main", options);
+		if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+			throw std::runtime_error("failed to compile shader " + path + "!\n" + result.GetErrorMessage());
+		}
+
+		return std::vector<uint32_t>(result.cbegin(), result.cend());
+	}
+
+	bool VulkanShaderManager::loadCachedSpirv(const std::string& cachePath, std::vector<uint32_t>* spirv) {
+		if (!File::exists(cachePath)) {
+			return false;
+		}
+
+		std::vector<char> bytes = File::readFile(cachePath);
+		if (bytes.empty() || bytes.size() % sizeof(uint32_t) != 0) {
+			return false;
+		}
+
+		spirv->resize(bytes.size() / sizeof(uint32_t));
+		memcpy(spirv->data(), bytes.data(), bytes.size());
+
+		// a truncated or foreign file is recompiled and overwritten
+		return (*spirv)[0] == SPIRV_MAGIC;
+	}
+
+	vk::ShaderModule VulkanShaderManager::createShaderModule(const std::vector<uint32_t>& spirv) {
+		vk::ShaderModuleCreateInfo createInfo = vk::ShaderModuleCreateInfo()
+			.setCodeSize(spirv.size() * sizeof(uint32_t))
+			.setPCode(spirv.data());
+
+		vk::ShaderModule shaderModule;
+		if (_logicalDevice->getObject()->createShaderModule(&createInfo, nullptr, &shaderModule) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create shader module!");
+		}
+
+		return shaderModule;
+	}
+}
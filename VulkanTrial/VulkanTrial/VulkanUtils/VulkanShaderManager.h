@@ -0,0 +1,60 @@
+#ifndef VulkanShaderManager_h_
+#define VulkanShaderManager_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include "VulkanShaderReflection.h"
+#include <shaderc/shaderc.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace litter {
+	class VulkanLogicalDevice;
+
+	struct VulkanShader {
+		VulkanShader(vk::ShaderModule shaderModule, const VulkanShaderReflection& shaderReflection)
+			: module(shaderModule), reflection(shaderReflection) {
+		}
+
+		vk::ShaderModule module;
+		VulkanShaderReflection reflection;
+	};
+
+	// compiles glsl sources at runtime. results are keyed by a hash of the source text, stage,
+	// defines and compiler options, kept in memory as shader modules and on disk as spir-v,
+	// so an unchanged shader is compiled once and never again on later runs
+	class VulkanShaderManager : public BaseObject {
+	public:
+		// name, value. an empty value defines the macro without one
+		typedef std::vector<std::pair<std::string, std::string>> Defines;
+
+		VulkanShaderManager(VulkanLogicalDevice* logicalDevice, const std::string& cacheDirectory);
+		~VulkanShaderManager();
+
+		// the stage is taken from the extension, .vert or .frag. the shader stays owned by the manager.
+		// safe to call from a background thread while pipelines are rebuilt
+		VulkanShader* getShader(const std::string& path, const Defines& defines);
+
+	private:
+		shaderc_shader_kind getShaderKind(const std::string& path);
+		uint64_t hashShader(const std::vector<char>& source, shaderc_shader_kind kind, const Defines& defines);
+		std::vector<uint32_t> compile(const std::string& path, const std::vector<char>& source, shaderc_shader_kind kind,
+			const Defines& defines);
+		bool loadCachedSpirv(const std::string& cachePath, std::vector<uint32_t>* spirv);
+		vk::ShaderModule createShaderModule(const std::vector<uint32_t>& spirv);
+
+	private:
+		static const shaderc_optimization_level OPTIMIZATION_LEVEL = shaderc_optimization_level_size;
+
+		std::unordered_map<uint64_t, VulkanShader*> _shaders;
+		std::string _cacheDirectory;
+		shaderc::Compiler _compiler;
+		std::mutex _mutex;
+
+		VulkanLogicalDevice* _logicalDevice;
+	};
+}
+
+#endif // !VulkanShaderManager_h_
@@ -0,0 +1,316 @@
+#include "VulkanShaderReflection.h"
+#include "StdC.h"
+#include <vulkan/spirv.hpp>
+
+namespace litter {
+	VulkanShaderReflection::VulkanShaderReflection(const std::vector<uint32_t>& spirv) {
+		_stage = vk::ShaderStageFlagBits::eVertex;
+		_pushConstantSize = 0;
+
+		parse(spirv);
+
+		std::sort(_vertexInputs.begin(), _vertexInputs.end(), [](const ShaderVertexInput& a, const ShaderVertexInput& b) {
+			return a.location < b.location;
+		});
+
+		_types.clear();
+		_constants.clear();
+		_decorations.clear();
+	}
+
+	vk::ShaderStageFlagBits VulkanShaderReflection::getStage() {
+		return _stage;
+	}
+
+	const std::vector<ShaderBinding>& VulkanShaderReflection::getBindings() {
+		return _bindings;
+	}
+
+	const std::vector<ShaderVertexInput>& VulkanShaderReflection::getVertexInputs() {
+		return _vertexInputs;
+	}
+
+	uint32_t VulkanShaderReflection::getPushConstantSize() {
+		return _pushConstantSize;
+	}
+
+	void VulkanShaderReflection::parse(const std::vector<uint32_t>& spirv) {
+		// header: magic, version, generator, id bound, schema
+		const size_t headerSize = 5;
+		if (spirv.size() < headerSize || spirv[0] != spv::MagicNumber) {
+			throw std::runtime_error("failed to reflect shader, not a spir-v module!");
+		}
+
+		struct Variable {
+			uint32_t typeId;
+			uint32_t id;
+			uint32_t storageClass;
+		};
+		std::vector<Variable> variables;
+
+		// decorations and types all precede the function bodies, variables are resolved once everything is known
+		size_t offset = headerSize;
+		while (offset < spirv.size()) {
+			uint32_t wordCount = spirv[offset] >> 16;
+			uint32_t op = spirv[offset] & 0xffff;
+			if (wordCount == 0 || offset + wordCount > spirv.size()) {
+				throw std::runtime_error("failed to reflect shader, truncated instruction!");
+			}
+			const uint32_t* operands = &spirv[offset + 1];
+			uint32_t operandCount = wordCount - 1;
+
+			switch (op) {
+			case spv::OpEntryPoint:
+				switch (operands[0]) {
+				case spv::ExecutionModelVertex:
+					_stage = vk::ShaderStageFlagBits::eVertex;
+					break;
+				case spv::ExecutionModelFragment:
+					_stage = vk::ShaderStageFlagBits::eFragment;
+					break;
+				case spv::ExecutionModelGeometry:
+					_stage = vk::ShaderStageFlagBits::eGeometry;
+					break;
+				case spv::ExecutionModelGLCompute:
+					_stage = vk::ShaderStageFlagBits::eCompute;
+					break;
+				case spv::ExecutionModelTessellationControl:
+					_stage = vk::ShaderStageFlagBits::eTessellationControl;
+					break;
+				case spv::ExecutionModelTessellationEvaluation:
+					_stage = vk::ShaderStageFlagBits::eTessellationEvaluation;
+					break;
+				default:
+					break;
+				}
+				break;
+
+			case spv::OpDecorate: {
+				Decorations& decorations = _decorations[operands[0]];
+				uint32_t value = operandCount > 2 ? operands[2] : 0;
+				switch (operands[1]) {
+				case spv::DecorationDescriptorSet: decorations.set = value; break;
+				case spv::DecorationBinding: decorations.binding = value; break;
+				case spv::DecorationLocation: decorations.location = value; break;
+				case spv::DecorationArrayStride: decorations.arrayStride = value; break;
+				case spv::DecorationBuiltIn: decorations.builtIn = true; break;
+				case spv::DecorationBlock: decorations.block = true; break;
+				case spv::DecorationBufferBlock: decorations.bufferBlock = true; break;
+				default: break;
+				}
+				break;
+			}
+
+			case spv::OpMemberDecorate: {
+				Decorations& decorations = _decorations[operands[0]];
+				uint32_t member = operands[1];
+				uint32_t value = operandCount > 3 ? operands[3] : 0;
+				if (operands[2] == spv::DecorationOffset) {
+					if (decorations.memberOffsets.size() <= member) {
+						decorations.memberOffsets.resize(member + 1, 0);
+					}
+					decorations.memberOffsets[member] = value;
+				} else if (operands[2] == spv::DecorationMatrixStride) {
+					// strides are per member, but a block only needs them for sizing so the widest one is kept
+					decorations.matrixStride = (std::max)(decorations.matrixStride, value);
+				} else if (operands[2] == spv::DecorationBuiltIn) {
+					decorations.builtIn = true;
+				}
+				break;
+			}
+
+			case spv::OpTypeBool:
+			case spv::OpTypeInt:
+			case spv::OpTypeFloat:
+			case spv::OpTypeVector:
+			case spv::OpTypeMatrix:
+			case spv::OpTypeImage:
+			case spv::OpTypeSampler:
+			case spv::OpTypeSampledImage:
+			case spv::OpTypeArray:
+			case spv::OpTypeRuntimeArray:
+			case spv::OpTypeStruct:
+			case spv::OpTypePointer: {
+				Type type;
+				type.op = op;
+				type.operands.assign(operands + 1, operands + operandCount);
+				_types[operands[0]] = type;
+				break;
+			}
+
+			case spv::OpConstant:
+			case spv::OpSpecConstant:
+				_constants[operands[1]] = operandCount > 2 ? operands[2] : 0;
+				break;
+
+			case spv::OpVariable: {
+				Variable variable = { operands[0], operands[1], operands[2] };
+				variables.push_back(variable);
+				break;
+			}
+
+			default:
+				break;
+			}
+
+			offset += wordCount;
+		}
+
+		for (const auto& variable : variables) {
+			addVariable(variable.typeId, variable.id, variable.storageClass);
+		}
+	}
+
+	void VulkanShaderReflection::addVariable(uint32_t typeId, uint32_t id, uint32_t storageClass) {
+		// variables are always declared through a pointer, the interesting type is what it points at
+		Type& pointer = _types[typeId];
+		uint32_t pointeeId = pointer.operands.size() > 1 ? pointer.operands[1] : 0;
+		Decorations& decorations = _decorations[id];
+
+		switch (storageClass) {
+		case spv::StorageClassUniform:
+		case spv::StorageClassUniformConstant:
+		case spv::StorageClassStorageBuffer: {
+			ShaderBinding binding;
+			binding.set = decorations.set;
+			binding.binding = decorations.binding;
+			binding.type = getDescriptorType(pointeeId, storageClass, &binding.count);
+			_bindings.push_back(binding);
+			break;
+		}
+
+		case spv::StorageClassPushConstant:
+			_pushConstantSize = (std::max)(_pushConstantSize, getTypeSize(pointeeId));
+			break;
+
+		case spv::StorageClassInput:
+			if (_stage == vk::ShaderStageFlagBits::eVertex && !decorations.builtIn && decorations.location != UINT32_MAX) {
+				ShaderVertexInput input;
+				input.location = decorations.location;
+				input.format = getVertexFormat(pointeeId, &input.size);
+				_vertexInputs.push_back(input);
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	vk::DescriptorType VulkanShaderReflection::getDescriptorType(uint32_t typeId, uint32_t storageClass, uint32_t* count) {
+		*count = 1;
+
+		Type* type = &_types[typeId];
+		while (type->op == spv::OpTypeArray || type->op == spv::OpTypeRuntimeArray) {
+			// a runtime array has no length to size the binding with, a single descriptor is assumed
+			if (type->op == spv::OpTypeArray) {
+				*count *= getConstant(type->operands[1]);
+			}
+			typeId = type->operands[0];
+			type = &_types[typeId];
+		}
+
+		if (storageClass == spv::StorageClassStorageBuffer || _decorations[typeId].bufferBlock) {
+			return vk::DescriptorType::eStorageBuffer;
+		}
+		if (storageClass == spv::StorageClassUniform) {
+			return vk::DescriptorType::eUniformBuffer;
+		}
+
+		switch (type->op) {
+		case spv::OpTypeSampler:
+			return vk::DescriptorType::eSampler;
+		case spv::OpTypeSampledImage:
+			return vk::DescriptorType::eCombinedImageSampler;
+		case spv::OpTypeImage: {
+			// operands: sampled type, dim, depth, arrayed, ms, sampled
+			uint32_t dim = type->operands[1];
+			uint32_t sampled = type->operands[5];
+			if (dim == spv::DimSubpassData) {
+				return vk::DescriptorType::eInputAttachment;
+			}
+			if (dim == spv::DimBuffer) {
+				return sampled == 2 ? vk::DescriptorType::eStorageTexelBuffer : vk::DescriptorType::eUniformTexelBuffer;
+			}
+			return sampled == 2 ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eSampledImage;
+		}
+		default:
+			throw std::runtime_error("failed to reflect shader, unsupported descriptor type!");
+		}
+	}
+
+	vk::Format VulkanShaderReflection::getVertexFormat(uint32_t typeId, uint32_t* size) {
+		Type& type = _types[typeId];
+
+		uint32_t componentTypeId = typeId;
+		uint32_t componentCount = 1;
+		if (type.op == spv::OpTypeVector) {
+			componentTypeId = type.operands[0];
+			componentCount = type.operands[1];
+		}
+
+		Type& component = _types[componentTypeId];
+		if (component.op != spv::OpTypeFloat && component.op != spv::OpTypeInt) {
+			throw std::runtime_error("failed to reflect shader, unsupported vertex input type!");
+		}
+		if (component.operands[0] != 32) {
+			throw std::runtime_error("failed to reflect shader, only 32 bit vertex inputs are supported!");
+		}
+
+		*size = componentCount * sizeof(uint32_t);
+
+		static const vk::Format floatFormats[] = { vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat };
+		static const vk::Format intFormats[] = { vk::Format::eR32Sint, vk::Format::eR32G32Sint, vk::Format::eR32G32B32Sint, vk::Format::eR32G32B32A32Sint };
+		static const vk::Format uintFormats[] = { vk::Format::eR32Uint, vk::Format::eR32G32Uint, vk::Format::eR32G32B32Uint, vk::Format::eR32G32B32A32Uint };
+
+		if (component.op == spv::OpTypeFloat) {
+			return floatFormats[componentCount - 1];
+		}
+		// operands of an int type: width, signedness
+		return component.operands[1] != 0 ? intFormats[componentCount - 1] : uintFormats[componentCount - 1];
+	}
+
+	uint32_t VulkanShaderReflection::getTypeSize(uint32_t typeId) {
+		Type& type = _types[typeId];
+		Decorations& decorations = _decorations[typeId];
+
+		switch (type.op) {
+		case spv::OpTypeBool:
+			return 4;
+		case spv::OpTypeInt:
+		case spv::OpTypeFloat:
+			return type.operands[0] / 8;
+		case spv::OpTypeVector:
+			return getTypeSize(type.operands[0]) * type.operands[1];
+		case spv::OpTypeMatrix:
+			// the stride is decorated on the struct member, not on the matrix type
+			return getTypeSize(type.operands[0]) * type.operands[1];
+		case spv::OpTypeArray: {
+			uint32_t stride = decorations.arrayStride > 0 ? decorations.arrayStride : getTypeSize(type.operands[0]);
+			return stride * getConstant(type.operands[1]);
+		}
+		case spv::OpTypeStruct: {
+			uint32_t size = 0;
+			for (size_t i = 0; i < type.operands.size(); i++) {
+				uint32_t memberOffset = i < decorations.memberOffsets.size() ? decorations.memberOffsets[i] : size;
+				uint32_t memberSize = getTypeSize(type.operands[i]);
+				if (_types[type.operands[i]].op == spv::OpTypeMatrix && decorations.matrixStride > 0) {
+					memberSize = decorations.matrixStride * _types[type.operands[i]].operands[1];
+				}
+				size = (std::max)(size, memberOffset + memberSize);
+			}
+			return size;
+		}
+		default:
+			return 0;
+		}
+	}
+
+	uint32_t VulkanShaderReflection::getConstant(uint32_t id) {
+		auto found = _constants.find(id);
+		if (found == _constants.end()) {
+			throw std::runtime_error("failed to reflect shader, array length is not a constant!");
+		}
+		return found->second;
+	}
+}
@@ -0,0 +1,74 @@
+#ifndef VulkanShaderReflection_h_
+#define VulkanShaderReflection_h_
+
+#include "VulkanHeader.h"
+#include <unordered_map>
+#include <vector>
+
+namespace litter {
+	struct ShaderBinding {
+		uint32_t set;
+		uint32_t binding;
+		vk::DescriptorType type;
+		uint32_t count;
+	};
+
+	struct ShaderVertexInput {
+		uint32_t location;
+		vk::Format format;
+		uint32_t size;
+	};
+
+	// reads the interface of one spir-v module: its stage, the descriptors it binds, the size of its
+	// push constant block and, for vertex shaders, the exact format of every input attribute
+	class VulkanShaderReflection {
+	public:
+		VulkanShaderReflection(const std::vector<uint32_t>& spirv);
+
+		vk::ShaderStageFlagBits getStage();
+		const std::vector<ShaderBinding>& getBindings();
+		// sorted by location, builtins are left out
+		const std::vector<ShaderVertexInput>& getVertexInputs();
+		// zero when the shader declares no push constant block
+		uint32_t getPushConstantSize();
+
+	private:
+		struct Type {
+			uint32_t op;
+			std::vector<uint32_t> operands;
+		};
+
+		struct Decorations {
+			uint32_t set = 0;
+			uint32_t binding = 0;
+			uint32_t location = UINT32_MAX;
+			uint32_t arrayStride = 0;
+			uint32_t matrixStride = 0;
+			bool builtIn = false;
+			bool block = false;
+			bool bufferBlock = false;
+			// only filled for struct types
+			std::vector<uint32_t> memberOffsets;
+		};
+
+		void parse(const std::vector<uint32_t>& spirv);
+		void addVariable(uint32_t typeId, uint32_t id, uint32_t storageClass);
+		vk::DescriptorType getDescriptorType(uint32_t typeId, uint32_t storageClass, uint32_t* count);
+		vk::Format getVertexFormat(uint32_t typeId, uint32_t* size);
+		uint32_t getTypeSize(uint32_t typeId);
+		uint32_t getConstant(uint32_t id);
+
+	private:
+		vk::ShaderStageFlagBits _stage;
+		std::vector<ShaderBinding> _bindings;
+		std::vector<ShaderVertexInput> _vertexInputs;
+		uint32_t _pushConstantSize;
+
+		// only needed while parsing
+		std::unordered_map<uint32_t, Type> _types;
+		std::unordered_map<uint32_t, uint32_t> _constants;
+		std::unordered_map<uint32_t, Decorations> _decorations;
+	};
+}
+
+#endif // !VulkanShaderReflection_h_
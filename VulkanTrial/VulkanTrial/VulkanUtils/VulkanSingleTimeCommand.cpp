@@ -1,6 +1,7 @@
 #include "VulkanSingleTimeCommand.h"
 #include "VulkanLogicalDevice.h"
 #include "VulkanCommandPool.h"
+#include "VulkanProfiler.h"
 
 namespace litter {
 	VulkanSingleTimeCommand::VulkanSingleTimeCommand(VulkanLogicalDevice* logicalDevice, VulkanCommandPool* commandPool) {
@@ -18,18 +19,31 @@ namespace litter {
 			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 
 		_commandBuffer.begin(&beginInfo);
+
+		if (_logicalDevice->getProfiler() != nullptr) {
+			_logicalDevice->getProfiler()->beginSingleTimeZone(&_commandBuffer);
+		}
 	}
 
 	VulkanSingleTimeCommand::~VulkanSingleTimeCommand() {
+		VulkanProfiler* profiler = _logicalDevice->getProfiler();
+		if (profiler != nullptr) {
+			profiler->endSingleTimeZone(&_commandBuffer);
+		}
+
 		_commandBuffer.end();
 
 		vk::SubmitInfo submitInfo = vk::SubmitInfo()
 			.setCommandBufferCount(1)
 			.setPCommandBuffers(&_commandBuffer);
 
-		_logicalDevice->getGraphicsQueue()->submit(1, &submitInfo, VK_NULL_HANDLE);
+		_logicalDevice->getGraphicsQueue()->submit(1, &submitInfo, vk::Fence());
 		_logicalDevice->getGraphicsQueue()->waitIdle();
 
+		if (profiler != nullptr) {
+			profiler->collectSingleTimeZone();
+		}
+
 		_logicalDevice->getObject()->freeCommandBuffers(*_commandPool->getObject(), 1, &_commandBuffer);
 	}
 
@@ -7,6 +7,9 @@ struct QueueFamilyIndices
 {
 	int graphicsFamily = -1;
 	int presentFamily = -1;
+	// never -1 once the graphics family is known, falls back to the graphics queue itself
+	int transferFamily = -1;
+	uint32_t transferQueueIndex = 0;
 
 	bool isComplete()
 	{
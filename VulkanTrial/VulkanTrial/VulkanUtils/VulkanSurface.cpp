@@ -1,10 +1,12 @@
 #include "VulkanSurface.h"
 #include "VulkanInstance.h"
+#include "StdC.h"
 
 namespace litter {
 	VulkanSurface::VulkanSurface(VulkanInstance* instance, SDL_Window* window) {
 		_instance = instance;
 
+#ifdef VK_USE_PLATFORM_WIN32_KHR
 		SDL_SysWMinfo windowInfo;
 		SDL_VERSION(&windowInfo.version);
 		if (!SDL_GetWindowWMInfo(window, &windowInfo)) {
@@ -18,6 +20,10 @@ namespace litter {
 			.setHinstance(GetModuleHandle(NULL))
 			.setHwnd(windowInfo.info.win.window);
 		_surface = instance->getObject()->createWin32SurfaceKHR(surfaceInfo);
+#else
+		(void)window;
+		throw std::runtime_error("failed to create window surface, run headless instead!");
+#endif
 	}
 
 	VulkanSurface::~VulkanSurface() {
@@ -3,22 +3,29 @@
 #include "VulkanLogicalDevice.h"
 #include "VulkanSurface.h"
 #include "VulkanStructs.h"
+#include "StdC.h"
 
 namespace litter {
 	VulkanSwapChain::VulkanSwapChain(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice, VulkanSurface* surface,
-		uint32_t width, uint32_t height) {
+		uint32_t width, uint32_t height, VulkanSwapChain* oldSwapChain) {
 		_logicalDevice = logicalDevice;
 		_physicalDevice = physicalDevice;
 		_surface = surface;
+		_nextOffscreenImage = 0;
 
-		init(width, height);
+		init(width, height, oldSwapChain);
 	}
 
 	VulkanSwapChain::~VulkanSwapChain() {
 		cleanup();
 	}
 
-	void VulkanSwapChain::init(uint32_t width, uint32_t height) {
+	void VulkanSwapChain::init(uint32_t width, uint32_t height, VulkanSwapChain* oldSwapChain) {
+		if (isHeadless()) {
+			createOffscreenImages(width, height);
+			return;
+		}
+
 		SwapChainSupportDetails* swapChainSupport = _physicalDevice->getSwapChainSupport();
 
 		vk::SurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport->formats);
@@ -57,8 +64,11 @@ namespace litter {
 		createInfo.setPresentMode(presentMode);
 		createInfo.setClipped(VK_TRUE);
 
-		createInfo.setOldSwapchain(VK_NULL_HANDLE);
-
+		if (oldSwapChain != nullptr) {
+			createInfo.setOldSwapchain(*oldSwapChain->getObject());
+		} else {
+			createInfo.setOldSwapchain(vk::SwapchainKHR());
+		}
 
 		if (_logicalDevice->getObject()->createSwapchainKHR(&createInfo, nullptr, &_swapChain) != vk::Result::eSuccess)
 		{
@@ -67,10 +77,68 @@ namespace litter {
 
 		_imageFormat = surfaceFormat.format;
 		_extent = extent;
+
+		uint32_t swapChainImageCount;
+		_logicalDevice->getObject()->getSwapchainImagesKHR(_swapChain, &swapChainImageCount, nullptr);
+		_images.resize(swapChainImageCount);
+		_logicalDevice->getObject()->getSwapchainImagesKHR(_swapChain, &swapChainImageCount, _images.data());
 	}
 
 	void VulkanSwapChain::cleanup() {
-		_logicalDevice->getObject()->destroySwapchainKHR(_swapChain, nullptr);
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		if (isHeadless()) {
+			for (size_t i = 0; i < _images.size(); i++) {
+				vkDevice->destroyImage(_images[i], nullptr);
+				_logicalDevice->getMemoryAllocator()->free(&_offscreenAllocations[i]);
+			}
+			_offscreenAllocations.clear();
+		} else {
+			vkDevice->destroySwapchainKHR(_swapChain, nullptr);
+		}
+		_images.clear();
+	}
+
+	vk::Result VulkanSwapChain::acquireNextImage(vk::Semaphore semaphore, uint32_t* imageIndex) {
+		if (isHeadless()) {
+			// the render pass dependency on earlier submissions already orders reuse of an offscreen image
+			*imageIndex = _nextOffscreenImage;
+			_nextOffscreenImage = (_nextOffscreenImage + 1) % static_cast<uint32_t>(_images.size());
+			return vk::Result::eSuccess;
+		}
+
+		return _logicalDevice->getObject()->acquireNextImageKHR(_swapChain, UINT64_MAX, semaphore, vk::Fence(), imageIndex);
+	}
+
+	vk::Result VulkanSwapChain::present(vk::Queue* queue, vk::Semaphore waitSemaphore, uint32_t imageIndex) {
+		if (isHeadless()) {
+			return vk::Result::eSuccess;
+		}
+
+		vk::PresentInfoKHR presentInfo = vk::PresentInfoKHR();
+
+		presentInfo.waitSemaphoreCount = 1;
+		presentInfo.pWaitSemaphores = &waitSemaphore;
+
+		presentInfo.swapchainCount = 1;
+		presentInfo.pSwapchains = &_swapChain;
+
+		presentInfo.pImageIndices = &imageIndex;
+
+		return queue->presentKHR(&presentInfo);
+	}
+
+	bool VulkanSwapChain::isHeadless() {
+		return _surface == nullptr;
+	}
+
+	vk::ImageLayout VulkanSwapChain::getFinalLayout() {
+		// offscreen images are left ready to be copied out by benchmarks or screenshots
+		return isHeadless() ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR;
+	}
+
+	std::vector<vk::Image>* VulkanSwapChain::getImages() {
+		return &_images;
 	}
 
 	vk::SwapchainKHR* VulkanSwapChain::getObject() {
@@ -93,6 +161,44 @@ namespace litter {
 		return _extent.height;
 	}
 
+	void VulkanSwapChain::createOffscreenImages(uint32_t width, uint32_t height) {
+		const uint32_t offscreenImageCount = 3;
+
+		_imageFormat = vk::Format::eR8G8B8A8Unorm;
+		_extent = vk::Extent2D(width, height);
+
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		_images.resize(offscreenImageCount);
+		_offscreenAllocations.resize(offscreenImageCount);
+		for (uint32_t i = 0; i < offscreenImageCount; i++) {
+			vk::ImageCreateInfo imageInfo = vk::ImageCreateInfo()
+				.setImageType(vk::ImageType::e2D)
+				.setExtent(
+					vk::Extent3D()
+					.setWidth(width)
+					.setHeight(height)
+					.setDepth(1)
+				)
+				.setMipLevels(1)
+				.setArrayLayers(1)
+				.setFormat(_imageFormat)
+				.setTiling(vk::ImageTiling::eOptimal)
+				.setInitialLayout(vk::ImageLayout::eUndefined)
+				.setUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc)
+				.setSharingMode(vk::SharingMode::eExclusive)
+				.setSamples(vk::SampleCountFlagBits::e1);
+
+			if (vkDevice->createImage(&imageInfo, nullptr, &_images[i]) != vk::Result::eSuccess) {
+				throw std::runtime_error("failed to create offscreen image!");
+			}
+
+			_offscreenAllocations[i] = _logicalDevice->getMemoryAllocator()->allocateImage(_images[i], vk::MemoryPropertyFlagBits::eDeviceLocal, true);
+		}
+
+		_nextOffscreenImage = 0;
+	}
+
 	vk::SurfaceFormatKHR VulkanSwapChain::chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats) {
 		if (availableFormats.size() == 1 && availableFormats[0].format == vk::Format::eUndefined) {
 			return{ vk::Format::eB8G8R8A8Unorm, vk::ColorSpaceKHR::eSrgbNonlinear };
@@ -122,14 +228,14 @@ namespace litter {
 	}
 
 	vk::Extent2D VulkanSwapChain::chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, uint32_t width, uint32_t height) {
-		if (capabilities.currentExtent.width != _ULLONG_MAX) {
+		if (capabilities.currentExtent.width != UINT32_MAX) {
 			return capabilities.currentExtent;
 		}
 		else {
 			vk::Extent2D actualExtent = { width, height };
 
-			actualExtent.width = max(capabilities.minImageExtent.width, min(capabilities.maxImageExtent.width, actualExtent.width));
-			actualExtent.height = max(capabilities.minImageExtent.height, min(capabilities.maxImageExtent.height, actualExtent.height));
+			actualExtent.width = (std::max)(capabilities.minImageExtent.width, (std::min)(capabilities.maxImageExtent.width, actualExtent.width));
+			actualExtent.height = (std::max)(capabilities.minImageExtent.height, (std::min)(capabilities.maxImageExtent.height, actualExtent.height));
 
 			return actualExtent;
 		}
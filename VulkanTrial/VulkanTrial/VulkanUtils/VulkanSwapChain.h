@@ -3,20 +3,32 @@
 
 #include "Base/BaseObject.h"
 #include "VulkanHeader.h"
+#include "VulkanMemoryAllocator.h"
+#include <vector>
 
 namespace litter {
 	class VulkanPhysicalDevice;
 	class VulkanLogicalDevice;
 	class VulkanSurface;
 
+	// without a surface the swap chain is replaced by a ring of offscreen color images,
+	// so the rest of the frame path renders exactly as it would to a window
 	class VulkanSwapChain : public BaseObject {
 	public:
+		// oldSwapChain may be null. when given, its images are handed over to the new swap chain,
+		// the old object stays valid until the frames still presenting from it are retired
 		VulkanSwapChain(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice, VulkanSurface* surface,
-			uint32_t width, uint32_t height);
+			uint32_t width, uint32_t height, VulkanSwapChain* oldSwapChain);
 		~VulkanSwapChain();
-		void init(uint32_t width, uint32_t height);
+		void init(uint32_t width, uint32_t height, VulkanSwapChain* oldSwapChain);
 		void cleanup();
 
+		vk::Result acquireNextImage(vk::Semaphore semaphore, uint32_t* imageIndex);
+		vk::Result present(vk::Queue* queue, vk::Semaphore waitSemaphore, uint32_t imageIndex);
+
+		bool isHeadless();
+		vk::ImageLayout getFinalLayout();
+		std::vector<vk::Image>* getImages();
 		vk::SwapchainKHR* getObject();
 		vk::Format* getImageFormat();
 		vk::Extent2D* getExtent();
@@ -26,11 +38,15 @@ namespace litter {
 		vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats);
 		vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR> availablePresentModes);
 		vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, uint32_t width, uint32_t height);
+		void createOffscreenImages(uint32_t width, uint32_t height);
 
 	private:
 		vk::SwapchainKHR _swapChain;
 		vk::Format _imageFormat;
 		vk::Extent2D _extent;
+		std::vector<vk::Image> _images;
+		std::vector<VulkanAllocation> _offscreenAllocations;
+		uint32_t _nextOffscreenImage;
 
 		VulkanLogicalDevice* _logicalDevice;
 		VulkanPhysicalDevice* _physicalDevice;
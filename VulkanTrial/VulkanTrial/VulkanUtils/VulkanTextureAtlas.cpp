@@ -0,0 +1,230 @@
+#include "VulkanTextureAtlas.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanLogicalDevice.h"
+#include "VulkanUploadManager.h"
+#include "VulkanSamplerCache.h"
+#include "Atlas/SkylinePacker.h"
+#include "StdC.h"
+
+namespace litter {
+	namespace {
+		const uint32_t ATLAS_PADDING = 1;
+	}
+
+	VulkanTextureAtlas::VulkanTextureAtlas(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanUploadManager* uploadManager,
+		uint32_t size, uint32_t layerCount) {
+		_physicalDevice = physicalDevice;
+		_logicalDevice = logicalDevice;
+		_uploadManager = uploadManager;
+		_size = size;
+		_layerCount = layerCount;
+
+		vk::PhysicalDeviceProperties properties;
+		_physicalDevice->getObject()->getProperties(&properties);
+		if (_size > properties.limits.maxImageDimension2D || _layerCount > properties.limits.maxImageArrayLayers) {
+			throw std::runtime_error("failed to create texture atlas, too large for the device!");
+		}
+
+		vk::ImageCreateInfo imageInfo = vk::ImageCreateInfo()
+			.setImageType(vk::ImageType::e2D)
+			.setExtent(
+				vk::Extent3D()
+				.setWidth(_size)
+				.setHeight(_size)
+				.setDepth(1)
+			)
+			.setMipLevels(1)
+			.setArrayLayers(_layerCount)
+			.setFormat(vk::Format::eR8G8B8A8Unorm)
+			.setTiling(vk::ImageTiling::eOptimal)
+			.setInitialLayout(vk::ImageLayout::eUndefined)
+			.setUsage(vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setSamples(vk::SampleCountFlagBits::e1);
+
+		if (_logicalDevice->getObject()->createImage(&imageInfo, nullptr, &_image) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create image!");
+		}
+		_imageAllocation = _logicalDevice->getMemoryAllocator()->allocateImage(_image, vk::MemoryPropertyFlagBits::eDeviceLocal, false);
+
+		vk::ImageSubresourceRange range = vk::ImageSubresourceRange()
+			.setAspectMask(vk::ImageAspectFlagBits::eColor)
+			.setBaseMipLevel(0)
+			.setLevelCount(1)
+			.setBaseArrayLayer(0)
+			.setLayerCount(_layerCount);
+
+		// every layer is sampled through the same view, so all of them need a defined layout before the first sprite lands
+		_uploadId = _uploadManager->clearImage(_image, range);
+
+		vk::ImageViewCreateInfo viewInfo = vk::ImageViewCreateInfo()
+			.setImage(_image)
+			.setViewType(vk::ImageViewType::e2DArray)
+			.setFormat(vk::Format::eR8G8B8A8Unorm)
+			.setSubresourceRange(range);
+		if (_logicalDevice->getObject()->createImageView(&viewInfo, nullptr, &_imageView) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create texture image view!");
+		}
+
+		vk::SamplerCreateInfo samplerInfo = vk::SamplerCreateInfo()
+			.setMagFilter(vk::Filter::eLinear)
+			.setMinFilter(vk::Filter::eLinear)
+			.setAddressModeU(vk::SamplerAddressMode::eClampToEdge)
+			.setAddressModeV(vk::SamplerAddressMode::eClampToEdge)
+			.setAddressModeW(vk::SamplerAddressMode::eClampToEdge)
+			.setAnisotropyEnable(VK_FALSE)
+			.setMaxAnisotropy(1)
+			.setBorderColor(vk::BorderColor::eIntOpaqueBlack)
+			.setUnnormalizedCoordinates(VK_FALSE)
+			.setCompareEnable(VK_FALSE)
+			.setCompareOp(vk::CompareOp::eAlways)
+			.setMipmapMode(vk::SamplerMipmapMode::eNearest)
+			.setMinLod(0.0f)
+			.setMaxLod(0.0f);
+
+		_sampler = _logicalDevice->getSamplerCache()->getSampler(samplerInfo);
+
+		for (uint32_t i = 0; i < _layerCount; i++) {
+			_packers.push_back(new SkylinePacker(_size, _size));
+		}
+	}
+
+	VulkanTextureAtlas::~VulkanTextureAtlas() {
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		for (SkylinePacker* packer : _packers) {
+			delete packer;
+		}
+		vkDevice->destroyImageView(_imageView, nullptr);
+		vkDevice->destroyImage(_image, nullptr);
+		_logicalDevice->getMemoryAllocator()->free(&_imageAllocation);
+	}
+
+	bool VulkanTextureAtlas::add(const AtlasImage& image, AtlasSprite* sprite) {
+		uint32_t x;
+		uint32_t y;
+		if (!place(image, sprite, &x, &y)) {
+			return false;
+		}
+
+		std::vector<char> data;
+		std::vector<vk::BufferImageCopy> regions;
+		regions.push_back(stageImage(image, x, y, sprite->layer, &data));
+		upload(data, regions);
+		return true;
+	}
+
+	bool VulkanTextureAtlas::addBatch(const std::vector<AtlasImage>& images, std::vector<AtlasSprite>* sprites) {
+		sprites->resize(images.size());
+
+		// tallest first keeps the skyline flat, which is most of what makes the packing tight
+		std::vector<size_t> order(images.size());
+		for (size_t i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&images](size_t a, size_t b) {
+			return images[a].height > images[b].height;
+		});
+
+		bool allPlaced = true;
+		std::vector<char> data;
+		std::vector<vk::BufferImageCopy> regions;
+		for (size_t index : order) {
+			AtlasSprite* sprite = &(*sprites)[index];
+			uint32_t x;
+			uint32_t y;
+			if (!place(images[index], sprite, &x, &y)) {
+				sprite->uvRect = glm::vec4(0.0f);
+				sprite->layer = UINT32_MAX;
+				allPlaced = false;
+				continue;
+			}
+			regions.push_back(stageImage(images[index], x, y, sprite->layer, &data));
+		}
+
+		if (!regions.empty()) {
+			upload(data, regions);
+		}
+		return allPlaced;
+	}
+
+	vk::ImageView* VulkanTextureAtlas::getObject() {
+		return &_imageView;
+	}
+
+	vk::Sampler* VulkanTextureAtlas::getSampler() {
+		return &_sampler;
+	}
+
+	uint32_t VulkanTextureAtlas::getLayerCount() {
+		return _layerCount;
+	}
+
+	uint64_t VulkanTextureAtlas::getUploadId() {
+		return _uploadId;
+	}
+
+	bool VulkanTextureAtlas::place(const AtlasImage& image, AtlasSprite* sprite, uint32_t* x, uint32_t* y) {
+		uint32_t paddedWidth = image.width + ATLAS_PADDING * 2;
+		uint32_t paddedHeight = image.height + ATLAS_PADDING * 2;
+		if (image.width == 0 || image.height == 0 || paddedWidth > _size || paddedHeight > _size) {
+			return false;
+		}
+
+		for (uint32_t layer = 0; layer < _layerCount; layer++) {
+			if (_packers[layer]->insert(paddedWidth, paddedHeight, x, y)) {
+				float scale = 1.0f / static_cast<float>(_size);
+				sprite->uvRect = glm::vec4(
+					static_cast<float>(*x + ATLAS_PADDING) * scale,
+					static_cast<float>(*y + ATLAS_PADDING) * scale,
+					static_cast<float>(*x + ATLAS_PADDING + image.width) * scale,
+					static_cast<float>(*y + ATLAS_PADDING + image.height) * scale);
+				sprite->layer = layer;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	vk::BufferImageCopy VulkanTextureAtlas::stageImage(const AtlasImage& image, uint32_t x, uint32_t y, uint32_t layer, std::vector<char>* data) {
+		uint32_t paddedWidth = image.width + ATLAS_PADDING * 2;
+		uint32_t paddedHeight = image.height + ATLAS_PADDING * 2;
+		size_t offset = data->size();
+		data->resize(offset + static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+
+		// the border repeats the nearest edge texel
+		const char* src = static_cast<const char*>(image.pixels);
+		char* dst = data->data() + offset;
+		for (uint32_t row = 0; row < paddedHeight; row++) {
+			uint32_t srcRow = (std::min)((std::max)(row, ATLAS_PADDING) - ATLAS_PADDING, image.height - 1);
+			for (uint32_t column = 0; column < paddedWidth; column++) {
+				uint32_t srcColumn = (std::min)((std::max)(column, ATLAS_PADDING) - ATLAS_PADDING, image.width - 1);
+				memcpy(dst + (static_cast<size_t>(row) * paddedWidth + column) * 4,
+					src + (static_cast<size_t>(srcRow) * image.width + srcColumn) * 4, 4);
+			}
+		}
+
+		return vk::BufferImageCopy()
+			.setBufferOffset(offset)
+			.setImageSubresource(
+				vk::ImageSubresourceLayers()
+				.setAspectMask(vk::ImageAspectFlagBits::eColor)
+				.setMipLevel(0)
+				.setBaseArrayLayer(layer)
+				.setLayerCount(1)
+			)
+			.setImageOffset(vk::Offset3D(static_cast<int32_t>(x), static_cast<int32_t>(y), 0))
+			.setImageExtent(vk::Extent3D(paddedWidth, paddedHeight, 1));
+	}
+
+	void VulkanTextureAtlas::upload(const std::vector<char>& data, const std::vector<vk::BufferImageCopy>& regions) {
+		vk::ImageSubresourceRange range = vk::ImageSubresourceRange()
+			.setAspectMask(vk::ImageAspectFlagBits::eColor)
+			.setBaseMipLevel(0)
+			.setLevelCount(1)
+			.setBaseArrayLayer(0)
+			.setLayerCount(_layerCount);
+
+		_uploadId = _uploadManager->updateImage(_image, data.data(), data.size(), regions, range);
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef VulkanTextureAtlas_h_
+#define VulkanTextureAtlas_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include "VulkanMemoryAllocator.h"
+#include <vector>
+
+namespace litter {
+	class VulkanPhysicalDevice;
+	class VulkanLogicalDevice;
+	class VulkanUploadManager;
+	class SkylinePacker;
+
+	struct AtlasSprite {
+		// u0, v0, u1, v1 of the sprite's texels, the padding around them is left out
+		glm::vec4 uvRect;
+		uint32_t layer;
+	};
+
+	struct AtlasImage {
+		uint32_t width;
+		uint32_t height;
+		// rgba8, only read during the add call
+		const void* pixels;
+	};
+
+	// packs many small rgba8 images into the layers of one 2d array texture, so sprites from any of them
+	// can share a descriptor set and a draw. every image gets a one texel border copied from its edges,
+	// linear filtering at the uv rect's edge never reaches a neighbour. single mip level, clamp to edge.
+	// adds belong on the render thread, the image is usable after the upload manager's next flush
+	class VulkanTextureAtlas : public BaseObject {
+	public:
+		VulkanTextureAtlas(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice, VulkanUploadManager* uploadManager,
+			uint32_t size, uint32_t layerCount);
+		~VulkanTextureAtlas();
+
+		// packs into the first layer with room, false when none has any. images added one at a time fill the
+		// layers in arrival order, prefer addBatch for anything known up front
+		bool add(const AtlasImage& image, AtlasSprite* sprite);
+		// packs the whole set tallest first and uploads it in one copy. sprites matches images in order,
+		// false when any of them didn't fit, those keep a layer of UINT32_MAX
+		bool addBatch(const std::vector<AtlasImage>& images, std::vector<AtlasSprite>* sprites);
+
+		vk::ImageView* getObject();
+		vk::Sampler* getSampler();
+		uint32_t getLayerCount();
+		// the upload batch holding the last add, see VulkanUploadManager::isComplete
+		uint64_t getUploadId();
+
+	private:
+		bool place(const AtlasImage& image, AtlasSprite* sprite, uint32_t* x, uint32_t* y);
+		// appends the image with its border to data and returns the copy region for it
+		vk::BufferImageCopy stageImage(const AtlasImage& image, uint32_t x, uint32_t y, uint32_t layer, std::vector<char>* data);
+		void upload(const std::vector<char>& data, const std::vector<vk::BufferImageCopy>& regions);
+
+	private:
+		vk::Image _image;
+		VulkanAllocation _imageAllocation;
+		vk::ImageView _imageView;
+		vk::Sampler _sampler;
+		uint32_t _size;
+		uint32_t _layerCount;
+		uint64_t _uploadId;
+		std::vector<SkylinePacker*> _packers;
+
+		VulkanPhysicalDevice* _physicalDevice;
+		VulkanLogicalDevice* _logicalDevice;
+		VulkanUploadManager* _uploadManager;
+	};
+}
+
+#endif // !VulkanTextureAtlas_h_
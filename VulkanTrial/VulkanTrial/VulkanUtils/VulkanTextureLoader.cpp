@@ -0,0 +1,214 @@
+#include "VulkanTextureLoader.h"
+#include "VulkanImageView.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanUploadManager.h"
+#include "File/File.h"
+#include "File/TextureFile.h"
+#include "Thread/ThreadPool.h"
+#include "StdC.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+namespace litter {
+	namespace {
+		// texel block footprint of the cooked formats, false for anything else
+		bool getBlockSize(vk::Format format, uint32_t* blockWidth, uint32_t* blockHeight, uint32_t* blockBytes) {
+			*blockWidth = 4;
+			*blockHeight = 4;
+			switch (format) {
+			case vk::Format::eBc1RgbaUnormBlock:
+			case vk::Format::eBc4UnormBlock:
+			case vk::Format::eEtc2R8G8B8UnormBlock:
+				*blockBytes = 8;
+				return true;
+			case vk::Format::eBc3UnormBlock:
+			case vk::Format::eBc5UnormBlock:
+			case vk::Format::eBc7UnormBlock:
+			case vk::Format::eEtc2R8G8B8A8UnormBlock:
+			case vk::Format::eAstc4x4UnormBlock:
+				*blockBytes = 16;
+				return true;
+			case vk::Format::eR8G8B8A8Unorm:
+				*blockWidth = 1;
+				*blockHeight = 1;
+				*blockBytes = 4;
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		// every level has to hold exactly the blocks its extent covers, the upload copies whole levels by extent
+		bool hasExpectedLevelSizes(const TextureFileData& cooked) {
+			uint32_t blockWidth;
+			uint32_t blockHeight;
+			uint32_t blockBytes;
+			if (!getBlockSize(static_cast<vk::Format>(cooked.format), &blockWidth, &blockHeight, &blockBytes)) {
+				return false;
+			}
+
+			for (size_t level = 0; level < cooked.levels.size(); level++) {
+				uint64_t width = (std::max)(cooked.width >> level, 1u);
+				uint64_t height = (std::max)(cooked.height >> level, 1u);
+				uint64_t expected = ((width + blockWidth - 1) / blockWidth) * ((height + blockHeight - 1) / blockHeight) * blockBytes;
+				if (cooked.levels[level].size() != expected) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	VulkanTextureLoader::VulkanTextureLoader(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice,
+		VulkanUploadManager* uploadManager, uint32_t threadCount) {
+		_physicalDevice = physicalDevice;
+		_logicalDevice = logicalDevice;
+		_uploadManager = uploadManager;
+		_threadPool = new ThreadPool(threadCount);
+
+		const vk::Format cookedFormats[] = {
+			vk::Format::eBc1RgbaUnormBlock,
+			vk::Format::eBc3UnormBlock,
+			vk::Format::eBc4UnormBlock,
+			vk::Format::eBc5UnormBlock,
+			vk::Format::eBc7UnormBlock,
+			vk::Format::eEtc2R8G8B8UnormBlock,
+			vk::Format::eEtc2R8G8B8A8UnormBlock,
+			vk::Format::eAstc4x4UnormBlock,
+			vk::Format::eR8G8B8A8Unorm
+		};
+		for (vk::Format format : cookedFormats) {
+			vk::FormatProperties properties;
+			_physicalDevice->getObject()->getFormatProperties(format, &properties);
+			if (properties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage) {
+				_sampledFormats.push_back(format);
+			}
+		}
+
+		// mid grey, so an unloaded texture neither flashes nor looks like a finished one
+		const uint8_t placeholderPixel[] = { 128, 128, 128, 255 };
+		_placeholder = new VulkanImageView(_physicalDevice, _logicalDevice, _uploadManager, 1, 1, placeholderPixel);
+	}
+
+	VulkanTextureLoader::~VulkanTextureLoader() {
+		// joins the workers, decodes still in flight finish into futures nobody reads
+		delete _threadPool;
+
+		for (Texture* texture : _textures) {
+			delete texture->imageView;
+			delete texture;
+		}
+		delete _placeholder;
+	}
+
+	TextureHandle VulkanTextureLoader::load(const std::string& path) {
+		auto found = _handles.find(path);
+		if (found != _handles.end()) {
+			return found->second;
+		}
+
+		Texture* texture = new Texture();
+		texture->path = path;
+		texture->state = TextureState::Decoding;
+		texture->imageView = nullptr;
+		texture->decode = _threadPool->enqueue([this, path]() {
+			return decode(path);
+		});
+
+		TextureHandle handle = static_cast<TextureHandle>(_textures.size());
+		_textures.push_back(texture);
+		_handles[path] = handle;
+		return handle;
+	}
+
+	void VulkanTextureLoader::update() {
+		for (Texture* texture : _textures) {
+			if (texture->state == TextureState::Decoding &&
+				texture->decode.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				try {
+					DecodedImage image = texture->decode.get();
+					if (image.levels.size() == 1 && image.format == vk::Format::eR8G8B8A8Unorm) {
+						texture->imageView = new VulkanImageView(_physicalDevice, _logicalDevice, _uploadManager,
+							image.width, image.height, image.levels[0].data());
+					}
+					else {
+						texture->imageView = new VulkanImageView(_physicalDevice, _logicalDevice, _uploadManager,
+							image.format, image.width, image.height, image.levels);
+					}
+					texture->state = TextureState::Uploading;
+				} catch (const std::runtime_error& e) {
+					std::cerr << "failed to load texture " << texture->path << ": " << e.what() << std::endl;
+					texture->state = TextureState::Failed;
+				}
+			}
+
+			if (texture->state == TextureState::Uploading && _uploadManager->isComplete(texture->imageView->getUploadId())) {
+				texture->state = TextureState::Ready;
+			}
+		}
+	}
+
+	bool VulkanTextureLoader::isReady(TextureHandle handle) {
+		return _textures[handle]->state == TextureState::Ready;
+	}
+
+	VulkanImageView* VulkanTextureLoader::getTexture(TextureHandle handle) {
+		Texture* texture = _textures[handle];
+		return texture->state == TextureState::Ready ? texture->imageView : _placeholder;
+	}
+
+	VulkanImageView* VulkanTextureLoader::getPlaceholder() {
+		return _placeholder;
+	}
+
+	VulkanTextureLoader::DecodedImage VulkanTextureLoader::decode(const std::string& path) {
+		std::string cookedPath = TextureFile::getCookedPath(path);
+		if (File::exists(cookedPath)) {
+			// a cooked file that is truncated or doesn't add up is passed over like one in a foreign format
+			TextureFileData cooked = TextureFileData();
+			bool valid = true;
+			try {
+				cooked = TextureFile::read(cookedPath);
+				valid = hasExpectedLevelSizes(cooked);
+			} catch (const std::runtime_error&) {
+				if (cookedPath == path) {
+					throw;
+				}
+				valid = false;
+			}
+
+			vk::Format format = static_cast<vk::Format>(cooked.format);
+			if (valid && std::find(_sampledFormats.begin(), _sampledFormats.end(), format) != _sampledFormats.end()) {
+				DecodedImage image;
+				image.format = format;
+				image.width = cooked.width;
+				image.height = cooked.height;
+				image.levels = std::move(cooked.levels);
+				return image;
+			}
+			// cooked for another gpu family, the source still works everywhere
+			if (cookedPath == path) {
+				throw std::runtime_error(valid ? "failed to load texture, its format can't be sampled on this device!" :
+					"failed to load texture, its mip levels don't match its format and size!");
+			}
+		}
+
+		int width;
+		int height;
+		int channels;
+		stbi_uc* pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+		if (!pixels) {
+			throw std::runtime_error(stbi_failure_reason());
+		}
+
+		DecodedImage image;
+		image.format = vk::Format::eR8G8B8A8Unorm;
+		image.width = static_cast<uint32_t>(width);
+		image.height = static_cast<uint32_t>(height);
+		image.levels.resize(1);
+		image.levels[0].assign(reinterpret_cast<char*>(pixels), reinterpret_cast<char*>(pixels) + static_cast<size_t>(width) * height * 4);
+		stbi_image_free(pixels);
+		return image;
+	}
+}
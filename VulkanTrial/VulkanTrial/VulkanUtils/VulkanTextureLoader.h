@@ -0,0 +1,82 @@
+#ifndef VulkanTextureLoader_h_
+#define VulkanTextureLoader_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace litter {
+	class VulkanPhysicalDevice;
+	class VulkanLogicalDevice;
+	class VulkanUploadManager;
+	class VulkanImageView;
+	class ThreadPool;
+
+	typedef uint32_t TextureHandle;
+
+	// decodes image files on worker threads and hands the pixels to the upload manager.
+	// a cooked .ktx2 next to the source image is preferred when the device can sample its format, its pre-built
+	// mip chain is uploaded as is. otherwise the source is decoded to rgba8 and its mips are generated on upload.
+	// until a texture's upload has completed, and for good when decoding failed, getTexture returns a placeholder.
+	// load, update and getTexture belong on the render thread, only decoding runs on the workers
+	class VulkanTextureLoader : public BaseObject {
+	public:
+		// decoding gets a pool of its own, on the shared one it would queue up in front of frame recording
+		VulkanTextureLoader(VulkanPhysicalDevice* physicalDevice, VulkanLogicalDevice* logicalDevice,
+			VulkanUploadManager* uploadManager, uint32_t threadCount);
+		~VulkanTextureLoader();
+
+		// the same path always returns the same handle
+		TextureHandle load(const std::string& path);
+		// call once per frame, uploads what finished decoding and promotes finished uploads
+		void update();
+
+		bool isReady(TextureHandle handle);
+		VulkanImageView* getTexture(TextureHandle handle);
+		// what getTexture hands out for textures that aren't ready, lives as long as the loader
+		VulkanImageView* getPlaceholder();
+
+	private:
+		struct DecodedImage {
+			vk::Format format;
+			uint32_t width;
+			uint32_t height;
+			// a single rgba8 level for decoded source images, the whole chain for cooked ones
+			std::vector<std::vector<char>> levels;
+		};
+
+		enum class TextureState {
+			Decoding,
+			Uploading,
+			Ready,
+			Failed
+		};
+
+		struct Texture {
+			std::string path;
+			TextureState state;
+			std::future<DecodedImage> decode;
+			VulkanImageView* imageView;
+		};
+
+		// runs on the workers, only reads _sampledFormats
+		DecodedImage decode(const std::string& path);
+
+	private:
+		std::vector<Texture*> _textures;
+		std::unordered_map<std::string, TextureHandle> _handles;
+		VulkanImageView* _placeholder;
+		// cooked formats the device can sample, filled once before any decode starts
+		std::vector<vk::Format> _sampledFormats;
+		ThreadPool* _threadPool;
+
+		VulkanPhysicalDevice* _physicalDevice;
+		VulkanLogicalDevice* _logicalDevice;
+		VulkanUploadManager* _uploadManager;
+	};
+}
+
+#endif // !VulkanTextureLoader_h_
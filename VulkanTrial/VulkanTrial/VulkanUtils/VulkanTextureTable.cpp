@@ -0,0 +1,133 @@
+#include "VulkanTextureTable.h"
+#include "VulkanLogicalDevice.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanDescriptorSetLayout.h"
+#include "VulkanDescriptorSetLayoutCache.h"
+#include "VulkanImageView.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanTextureTable::VulkanTextureTable(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
+		VulkanDescriptorSetLayoutCache* layoutCache, uint32_t frameCount, VulkanImageView* fallback) {
+		_logicalDevice = logicalDevice;
+		_fallback = fallback;
+
+		vk::PhysicalDeviceProperties properties;
+		physicalDevice->getObject()->getProperties(&properties);
+		if (properties.limits.maxPerStageDescriptorSamplers < TEXTURE_TABLE_SIZE ||
+			properties.limits.maxPerStageDescriptorSampledImages < TEXTURE_TABLE_SIZE) {
+			throw std::runtime_error("failed to create texture table, too many samplers for the device!");
+		}
+
+		// the same bindings the shaders reflect to, so the cache hands back the pipelines' own layout
+		vk::DescriptorSetLayoutBinding binding = vk::DescriptorSetLayoutBinding()
+			.setBinding(0)
+			.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+			.setDescriptorCount(TEXTURE_TABLE_SIZE)
+			.setStageFlags(vk::ShaderStageFlagBits::eFragment);
+		VulkanDescriptorSetLayout* layout = layoutCache->getLayout({ binding });
+
+		vk::DescriptorPoolSize poolSize = vk::DescriptorPoolSize()
+			.setType(vk::DescriptorType::eCombinedImageSampler)
+			.setDescriptorCount(TEXTURE_TABLE_SIZE * frameCount);
+
+		vk::DescriptorPoolCreateInfo poolInfo = vk::DescriptorPoolCreateInfo()
+			.setPoolSizeCount(1)
+			.setPPoolSizes(&poolSize)
+			.setMaxSets(frameCount);
+
+		if (_logicalDevice->getObject()->createDescriptorPool(&poolInfo, nullptr, &_descriptorPool) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create descriptor pool!");
+		}
+
+		std::vector<vk::DescriptorSetLayout> layouts(frameCount, *layout->getObject());
+		_descriptorSets.resize(frameCount);
+
+		vk::DescriptorSetAllocateInfo allocInfo = vk::DescriptorSetAllocateInfo()
+			.setDescriptorPool(_descriptorPool)
+			.setDescriptorSetCount(frameCount)
+			.setPSetLayouts(layouts.data());
+
+		if (_logicalDevice->getObject()->allocateDescriptorSets(&allocInfo, _descriptorSets.data()) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to allocate descriptor set!");
+		}
+
+		// nothing written yet, so the first update of every copy writes the whole array
+		_slots.resize(TEXTURE_TABLE_SIZE, _fallback);
+		_written.resize(frameCount, std::vector<vk::ImageView>(TEXTURE_TABLE_SIZE));
+		for (uint32_t i = TEXTURE_TABLE_SIZE; i > 0; i--) {
+			_freeSlots.push_back(i - 1);
+		}
+	}
+
+	VulkanTextureTable::~VulkanTextureTable() {
+		// destroying the pool frees the sets
+		_logicalDevice->getObject()->destroyDescriptorPool(_descriptorPool, nullptr);
+	}
+
+	uint32_t VulkanTextureTable::allocate(VulkanImageView* texture) {
+		if (_freeSlots.empty()) {
+			throw std::runtime_error("failed to allocate texture table slot, the table is full!");
+		}
+
+		uint32_t slot = _freeSlots.back();
+		_freeSlots.pop_back();
+		set(slot, texture);
+		return slot;
+	}
+
+	void VulkanTextureTable::release(uint32_t slot) {
+		set(slot, _fallback);
+		_freeSlots.push_back(slot);
+	}
+
+	void VulkanTextureTable::set(uint32_t slot, VulkanImageView* texture) {
+		_slots[slot] = texture;
+	}
+
+	vk::DescriptorSet VulkanTextureTable::update(uint32_t frameIndex) {
+		std::vector<vk::ImageView>& written = _written[frameIndex];
+
+		// runs of neighbouring changed slots go out as one write. the infos are reserved up front,
+		// the writes point into them
+		std::vector<vk::DescriptorImageInfo> imageInfos;
+		imageInfos.reserve(TEXTURE_TABLE_SIZE);
+		std::vector<vk::WriteDescriptorSet> descriptorWrites;
+
+		for (uint32_t slot = 0; slot < TEXTURE_TABLE_SIZE; slot++) {
+			vk::ImageView imageView = *_slots[slot]->getObject();
+			if (written[slot] == imageView) {
+				continue;
+			}
+
+			imageInfos.push_back(vk::DescriptorImageInfo()
+				.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+				.setImageView(imageView)
+				.setSampler(*_slots[slot]->getSampler()));
+			written[slot] = imageView;
+
+			if (!descriptorWrites.empty()) {
+				vk::WriteDescriptorSet& last = descriptorWrites.back();
+				if (last.dstArrayElement + last.descriptorCount == slot) {
+					last.descriptorCount++;
+					continue;
+				}
+			}
+
+			descriptorWrites.push_back(vk::WriteDescriptorSet()
+				.setDstSet(_descriptorSets[frameIndex])
+				.setDstBinding(0)
+				.setDstArrayElement(slot)
+				.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+				.setDescriptorCount(1)
+				.setPBufferInfo(nullptr)
+				.setPImageInfo(&imageInfos.back())
+				.setPTexelBufferView(nullptr));
+		}
+
+		if (!descriptorWrites.empty()) {
+			_logicalDevice->getObject()->updateDescriptorSets(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+		}
+		return _descriptorSets[frameIndex];
+	}
+}
@@ -0,0 +1,54 @@
+#ifndef VulkanTextureTable_h_
+#define VulkanTextureTable_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include <vector>
+
+namespace litter {
+	class VulkanLogicalDevice;
+	class VulkanPhysicalDevice;
+	class VulkanDescriptorSetLayoutCache;
+	class VulkanImageView;
+
+	// has to match the sampler array the shaders declare at set TEXTURE_TABLE_SET, binding 0
+	const uint32_t TEXTURE_TABLE_SIZE = 64;
+	const uint32_t TEXTURE_TABLE_SET = 1;
+
+	// every texture a frame may sample, in one array of combined image samplers that stays bound for the whole frame.
+	// draws pick their texture by slot index, usually through a push constant, so switching textures needs no rebind.
+	// without update-after-bind a set can't change while a frame using it is in flight, so there is one copy per
+	// frame in flight and each copy catches up on the changed slots when its frame comes around again.
+	// unused slots point at the fallback texture, the whole array is always valid to index
+	class VulkanTextureTable : public BaseObject {
+	public:
+		VulkanTextureTable(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
+			VulkanDescriptorSetLayoutCache* layoutCache, uint32_t frameCount, VulkanImageView* fallback);
+		~VulkanTextureTable();
+
+		// lowest free slot, throws when the table is full
+		uint32_t allocate(VulkanImageView* texture);
+		// points the slot back at the fallback and hands it to a later allocate. frames in flight may still
+		// sample the old texture, keep it alive until they have completed
+		void release(uint32_t slot);
+		void set(uint32_t slot, VulkanImageView* texture);
+
+		// writes whatever changed since the frame's copy was last brought up to date and returns it,
+		// call once per frame after its fence has signaled
+		vk::DescriptorSet update(uint32_t frameIndex);
+
+	private:
+		vk::DescriptorPool _descriptorPool;
+		std::vector<vk::DescriptorSet> _descriptorSets;
+		std::vector<VulkanImageView*> _slots;
+		// what each frame's copy currently points at, per slot
+		std::vector<std::vector<vk::ImageView>> _written;
+		// popped from the back, filled highest first so the low slots go out first
+		std::vector<uint32_t> _freeSlots;
+		VulkanImageView* _fallback;
+
+		VulkanLogicalDevice* _logicalDevice;
+	};
+}
+
+#endif // !VulkanTextureTable_h_
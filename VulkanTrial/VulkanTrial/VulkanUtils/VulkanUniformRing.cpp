@@ -0,0 +1,55 @@
+#include "VulkanUniformRing.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanLogicalDevice.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanUniformRing::VulkanUniformRing(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
+		uint32_t frameCount, vk::DeviceSize frameSize) {
+		_logicalDevice = logicalDevice;
+
+		vk::PhysicalDeviceProperties properties;
+		physicalDevice->getObject()->getProperties(&properties);
+		_alignment = properties.limits.minUniformBufferOffsetAlignment;
+
+		// every region has to start on an aligned offset as well
+		_frameSize = (frameSize + _alignment - 1) & ~(_alignment - 1);
+		_frameStart = 0;
+		_cursor = 0;
+
+		_logicalDevice->getMemoryAllocator()->createBuffer(_frameSize * frameCount, vk::BufferUsageFlagBits::eUniformBuffer,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+			&_buffer, &_allocation);
+	}
+
+	VulkanUniformRing::~VulkanUniformRing() {
+		_logicalDevice->getMemoryAllocator()->destroyBuffer(&_buffer, &_allocation);
+	}
+
+	void VulkanUniformRing::beginFrame(uint32_t frameIndex) {
+		_frameStart = _frameSize * frameIndex;
+		_cursor = _frameStart;
+	}
+
+	void* VulkanUniformRing::allocate(vk::DeviceSize size, uint32_t* dynamicOffset) {
+		vk::DeviceSize offset = (_cursor + _alignment - 1) & ~(_alignment - 1);
+		if (offset + size > _frameStart + _frameSize) {
+			throw std::runtime_error("uniform ring is full for this frame!");
+		}
+
+		_cursor = offset + size;
+		*dynamicOffset = static_cast<uint32_t>(offset);
+		return static_cast<char*>(_allocation.mapped) + offset;
+	}
+
+	vk::Buffer* VulkanUniformRing::getObject() {
+		return &_buffer;
+	}
+
+	vk::DescriptorBufferInfo VulkanUniformRing::getBufferInfo(vk::DeviceSize range) {
+		return vk::DescriptorBufferInfo()
+			.setBuffer(_buffer)
+			.setOffset(0)
+			.setRange(range);
+	}
+}
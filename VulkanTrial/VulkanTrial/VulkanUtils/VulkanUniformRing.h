@@ -0,0 +1,42 @@
+#ifndef VulkanUniformRing_h_
+#define VulkanUniformRing_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include "VulkanMemoryAllocator.h"
+
+namespace litter {
+	class VulkanPhysicalDevice;
+	class VulkanLogicalDevice;
+
+	// one persistently mapped uniform buffer cut into a region per frame in flight.
+	// uniforms are bump allocated from the current frame's region and bound with a dynamic offset,
+	// so the cpu only ever writes a region whose frame fence has already signaled
+	class VulkanUniformRing : public BaseObject {
+	public:
+		VulkanUniformRing(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice,
+			uint32_t frameCount, vk::DeviceSize frameSize);
+		~VulkanUniformRing();
+
+		// call after waiting on the frame, everything handed out for the slot before is overwritten
+		void beginFrame(uint32_t frameIndex);
+		// returns where to write size bytes, dynamicOffset is what to pass when binding
+		void* allocate(vk::DeviceSize size, uint32_t* dynamicOffset);
+
+		vk::Buffer* getObject();
+		// for a dynamic uniform descriptor, range is the size a shader reads from each offset
+		vk::DescriptorBufferInfo getBufferInfo(vk::DeviceSize range);
+
+	private:
+		vk::Buffer _buffer;
+		VulkanAllocation _allocation;
+		vk::DeviceSize _frameSize;
+		vk::DeviceSize _alignment;
+		vk::DeviceSize _frameStart;
+		vk::DeviceSize _cursor;
+
+		VulkanLogicalDevice* _logicalDevice;
+	};
+}
+
+#endif // !VulkanUniformRing_h_
@@ -0,0 +1,633 @@
+#include "VulkanUploadManager.h"
+#include "VulkanPhysicalDevice.h"
+#include "VulkanLogicalDevice.h"
+#include "VulkanProfiler.h"
+#include "VulkanStructs.h"
+#include "StdC.h"
+
+namespace litter {
+	VulkanUploadManager::VulkanUploadManager(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice, vk::DeviceSize stagingSize) {
+		_logicalDevice = logicalDevice;
+		_stagingSize = stagingSize;
+		_head = 0;
+		_tail = 0;
+		_nextId = 1;
+		_completedId = 0;
+
+		// 16 covers the texel blocks of every format, including compressed ones
+		vk::PhysicalDeviceProperties properties;
+		physicalDevice->getObject()->getProperties(&properties);
+		_alignment = (std::max)(static_cast<vk::DeviceSize>(16), properties.limits.optimalBufferCopyOffsetAlignment);
+
+		QueueFamilyIndices* queueFamilyIndices = physicalDevice->getQueueFamilyIndices();
+		_transferFamily = queueFamilyIndices->transferFamily;
+		_graphicsFamily = queueFamilyIndices->graphicsFamily;
+		_separateQueue = _transferFamily != _graphicsFamily || queueFamilyIndices->transferQueueIndex != 0;
+
+		// image updates copy from staging on the graphics queue, the transfer queue reads the rest
+		if (_transferFamily != _graphicsFamily) {
+			_stagingFamilies.push_back(_transferFamily);
+			_stagingFamilies.push_back(_graphicsFamily);
+		}
+
+		_logicalDevice->getMemoryAllocator()->createBuffer(_stagingSize, vk::BufferUsageFlagBits::eTransferSrc,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+			&_stagingBuffer, &_stagingAllocation, _stagingFamilies);
+
+		vk::CommandPoolCreateInfo poolInfo = vk::CommandPoolCreateInfo()
+			.setQueueFamilyIndex(_transferFamily)
+			.setFlags(vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+
+		if (_logicalDevice->getObject()->createCommandPool(&poolInfo, nullptr, &_commandPool) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to create command pool!");
+		}
+
+		if (_separateQueue) {
+			poolInfo.setQueueFamilyIndex(_graphicsFamily);
+			if (_logicalDevice->getObject()->createCommandPool(&poolInfo, nullptr, &_acquireCommandPool) != vk::Result::eSuccess) {
+				throw std::runtime_error("failed to create command pool!");
+			}
+		}
+
+		_queue = _logicalDevice->getTransferQueue();
+		_graphicsQueue = _logicalDevice->getGraphicsQueue();
+		_current = acquireBatch();
+	}
+
+	VulkanUploadManager::~VulkanUploadManager() {
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		while (!_pending.empty()) {
+			retireCompleted(true);
+		}
+
+		// anything still being collected was never submitted and is dropped
+		_freeBatches.push_back(_current);
+		for (UploadBatch* batch : _freeBatches) {
+			for (size_t i = 0; i < batch->oversizedBuffers.size(); i++) {
+				_logicalDevice->getMemoryAllocator()->destroyBuffer(&batch->oversizedBuffers[i], &batch->oversizedAllocations[i]);
+			}
+			vkDevice->destroyFence(batch->fence, nullptr);
+			if (_separateQueue) {
+				vkDevice->destroySemaphore(batch->semaphore, nullptr);
+			}
+			delete batch;
+		}
+
+		// destroying the pools frees the batches' command buffers
+		vkDevice->destroyCommandPool(_commandPool, nullptr);
+		if (_separateQueue) {
+			vkDevice->destroyCommandPool(_acquireCommandPool, nullptr);
+		}
+		_logicalDevice->getMemoryAllocator()->destroyBuffer(&_stagingBuffer, &_stagingAllocation);
+	}
+
+	uint64_t VulkanUploadManager::uploadBuffer(vk::Buffer buffer, vk::DeviceSize offset, const void* data, vk::DeviceSize size) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		vk::DeviceSize srcOffset;
+		vk::Buffer srcBuffer = stage(data, size, &srcOffset);
+
+		vk::BufferCopy copyRegion = vk::BufferCopy()
+			.setSrcOffset(srcOffset)
+			.setDstOffset(offset)
+			.setSize(size);
+		beginCommands()->copyBuffer(srcBuffer, buffer, 1, &copyRegion);
+
+		if (_separateQueue) {
+			bool ownershipTransfer = _transferFamily != _graphicsFamily;
+			_current->bufferAcquires.push_back(vk::BufferMemoryBarrier()
+				.setSrcAccessMask(ownershipTransfer ? vk::AccessFlags() : vk::AccessFlagBits::eTransferWrite)
+				.setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+					vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead)
+				.setSrcQueueFamilyIndex(ownershipTransfer ? _transferFamily : VK_QUEUE_FAMILY_IGNORED)
+				.setDstQueueFamilyIndex(ownershipTransfer ? _graphicsFamily : VK_QUEUE_FAMILY_IGNORED)
+				.setBuffer(buffer)
+				.setOffset(offset)
+				.setSize(size));
+		}
+
+		return _current->id;
+	}
+
+	uint64_t VulkanUploadManager::uploadImage(vk::Image image, const void* data, vk::DeviceSize size,
+		const std::vector<vk::BufferImageCopy>& regions, const vk::ImageSubresourceRange& range, bool generateMips) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		vk::DeviceSize srcOffset;
+		vk::Buffer srcBuffer = stage(data, size, &srcOffset);
+
+		std::vector<vk::BufferImageCopy> stagedRegions = regions;
+		for (auto& region : stagedRegions) {
+			region.bufferOffset += srcOffset;
+		}
+
+		vk::CommandBuffer* commandBuffer = beginCommands();
+
+		vk::ImageMemoryBarrier toTransfer = vk::ImageMemoryBarrier()
+			.setOldLayout(vk::ImageLayout::eUndefined)
+			.setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setImage(image)
+			.setSubresourceRange(range)
+			.setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+		commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(),
+			0, nullptr,
+			0, nullptr,
+			1, &toTransfer);
+
+		commandBuffer->copyBufferToImage(srcBuffer, image, vk::ImageLayout::eTransferDstOptimal,
+			static_cast<uint32_t>(stagedRegions.size()), stagedRegions.data());
+
+		vk::Extent3D baseExtent = regions[0].imageExtent;
+
+		if (_separateQueue) {
+			// the release recorded at submit moves the image to its layout on the graphics side, the acquire only makes it visible
+			// unless ownership moves with it, in which case both halves carry the same transition.
+			// images that still need their mips stay in transfer dst until the blits in the acquire submission
+			bool ownershipTransfer = _transferFamily != _graphicsFamily;
+			vk::ImageLayout layout = generateMips ? vk::ImageLayout::eTransferDstOptimal : vk::ImageLayout::eShaderReadOnlyOptimal;
+			_current->imageAcquires.push_back(vk::ImageMemoryBarrier()
+				.setOldLayout(ownershipTransfer ? vk::ImageLayout::eTransferDstOptimal : layout)
+				.setNewLayout(layout)
+				.setSrcQueueFamilyIndex(ownershipTransfer ? _transferFamily : VK_QUEUE_FAMILY_IGNORED)
+				.setDstQueueFamilyIndex(ownershipTransfer ? _graphicsFamily : VK_QUEUE_FAMILY_IGNORED)
+				.setImage(image)
+				.setSubresourceRange(range)
+				.setSrcAccessMask(ownershipTransfer ? vk::AccessFlags() : vk::AccessFlagBits::eTransferWrite)
+				.setDstAccessMask(generateMips ? vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite : vk::AccessFlagBits::eShaderRead));
+
+			if (generateMips) {
+				UploadBatch::MipGeneration mipGeneration = { image, baseExtent, range };
+				_current->mipGenerations.push_back(mipGeneration);
+			}
+			return _current->id;
+		}
+
+		if (generateMips) {
+			recordMipGeneration(commandBuffer, image, baseExtent, range);
+			return _current->id;
+		}
+
+		vk::ImageMemoryBarrier toShaderRead = vk::ImageMemoryBarrier()
+			.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+			.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setImage(image)
+			.setSubresourceRange(range)
+			.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+			.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+		commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+			vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader, vk::DependencyFlags(),
+			0, nullptr,
+			0, nullptr,
+			1, &toShaderRead);
+
+		return _current->id;
+	}
+
+	uint64_t VulkanUploadManager::updateImage(vk::Image image, const void* data, vk::DeviceSize size,
+		const std::vector<vk::BufferImageCopy>& regions, const vk::ImageSubresourceRange& range) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		UploadBatch::ImageUpdate update;
+		update.image = image;
+		update.range = range;
+		vk::DeviceSize srcOffset;
+		update.srcBuffer = stage(data, size, &srcOffset);
+		update.regions = regions;
+		for (auto& region : update.regions) {
+			region.bufferOffset += srcOffset;
+		}
+
+		return queueImageUpdate(&update);
+	}
+
+	uint64_t VulkanUploadManager::clearImage(vk::Image image, const vk::ImageSubresourceRange& range) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		UploadBatch::ImageUpdate update;
+		update.image = image;
+		update.range = range;
+
+		return queueImageUpdate(&update);
+	}
+
+	uint64_t VulkanUploadManager::flush() {
+		ProfileZone zone(_logicalDevice->getProfiler(), "uploadFlush");
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		retireCompleted(false);
+		return submitCurrent();
+	}
+
+	bool VulkanUploadManager::isComplete(uint64_t id) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		retireCompleted(false);
+		return id <= _completedId;
+	}
+
+	void VulkanUploadManager::wait(uint64_t id) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		if (id >= _current->id) {
+			submitCurrent();
+		}
+		while (_completedId < id && !_pending.empty()) {
+			retireCompleted(true);
+		}
+	}
+
+	vk::Buffer VulkanUploadManager::stage(const void* data, vk::DeviceSize size, vk::DeviceSize* offset) {
+		if (size > _stagingSize) {
+			vk::Buffer buffer;
+			VulkanAllocation allocation;
+			_logicalDevice->getMemoryAllocator()->createBuffer(size, vk::BufferUsageFlagBits::eTransferSrc,
+				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+				&buffer, &allocation, _stagingFamilies);
+			memcpy(allocation.mapped, data, static_cast<size_t>(size));
+
+			_current->oversizedBuffers.push_back(buffer);
+			_current->oversizedAllocations.push_back(allocation);
+			*offset = 0;
+			return buffer;
+		}
+
+		// the ring is full of copies that have not run yet, submit ours and wait for the oldest to free its space
+		while (!tryAllocateStaging(size, offset)) {
+			if (_current->usesStaging) {
+				submitCurrent();
+			}
+			if (_pending.empty()) {
+				throw std::runtime_error("failed to allocate upload staging memory!");
+			}
+			retireCompleted(true);
+		}
+
+		memcpy(static_cast<char*>(_stagingAllocation.mapped) + *offset, data, static_cast<size_t>(size));
+
+		_head = *offset + size;
+		_current->usesStaging = true;
+		_current->stagingEnd = _head;
+		return _stagingBuffer;
+	}
+
+	bool VulkanUploadManager::tryAllocateStaging(vk::DeviceSize size, vk::DeviceSize* offset) {
+		bool empty = !_current->usesStaging;
+		for (UploadBatch* batch : _pending) {
+			empty = empty && !batch->usesStaging;
+		}
+		if (empty) {
+			_head = 0;
+			_tail = 0;
+		}
+
+		vk::DeviceSize start = (_head + _alignment - 1) & ~(_alignment - 1);
+
+		// free space is [head, end) and [0, tail) while the live range does not wrap, [head, tail) while it does.
+		// head meeting tail with copies in flight means the ring is full
+		if (empty || _head > _tail) {
+			if (start + size <= _stagingSize) {
+				*offset = start;
+				return true;
+			}
+			if (size <= _tail) {
+				*offset = 0;
+				return true;
+			}
+		} else if (_head < _tail && start + size <= _tail) {
+			*offset = start;
+			return true;
+		}
+		return false;
+	}
+
+	VulkanUploadManager::UploadBatch* VulkanUploadManager::acquireBatch() {
+		UploadBatch* batch;
+		if (!_freeBatches.empty()) {
+			batch = _freeBatches.back();
+			_freeBatches.pop_back();
+		} else {
+			batch = new UploadBatch();
+
+			vk::CommandBufferAllocateInfo allocInfo = vk::CommandBufferAllocateInfo()
+				.setCommandPool(_commandPool)
+				.setLevel(vk::CommandBufferLevel::ePrimary)
+				.setCommandBufferCount(1);
+
+			if (_logicalDevice->getObject()->allocateCommandBuffers(&allocInfo, &batch->commandBuffer) != vk::Result::eSuccess) {
+				throw std::runtime_error("failed to allocate command buffers!");
+			}
+
+			vk::FenceCreateInfo fenceInfo = vk::FenceCreateInfo();
+			if (_logicalDevice->getObject()->createFence(&fenceInfo, nullptr, &batch->fence) != vk::Result::eSuccess) {
+				throw std::runtime_error("failed to create fence!");
+			}
+
+			if (_separateQueue) {
+				allocInfo.setCommandPool(_acquireCommandPool);
+				if (_logicalDevice->getObject()->allocateCommandBuffers(&allocInfo, &batch->acquireCommandBuffer) != vk::Result::eSuccess) {
+					throw std::runtime_error("failed to allocate command buffers!");
+				}
+
+				vk::SemaphoreCreateInfo semaphoreInfo = vk::SemaphoreCreateInfo();
+				if (_logicalDevice->getObject()->createSemaphore(&semaphoreInfo, nullptr, &batch->semaphore) != vk::Result::eSuccess) {
+					throw std::runtime_error("failed to create semaphore!");
+				}
+			}
+		}
+
+		batch->id = _nextId++;
+		batch->recording = false;
+		batch->usesStaging = false;
+		batch->stagingEnd = 0;
+		return batch;
+	}
+
+	vk::CommandBuffer* VulkanUploadManager::beginCommands() {
+		if (!_current->recording) {
+			vk::CommandBufferBeginInfo beginInfo = vk::CommandBufferBeginInfo()
+				.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+			_current->commandBuffer.begin(&beginInfo);
+			_current->recording = true;
+		}
+		return &_current->commandBuffer;
+	}
+
+	void VulkanUploadManager::recordMipGeneration(vk::CommandBuffer* commandBuffer, vk::Image image, vk::Extent3D extent, const vk::ImageSubresourceRange& range) {
+		vk::ImageMemoryBarrier barrier = vk::ImageMemoryBarrier()
+			.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setImage(image)
+			.setSubresourceRange(range);
+		barrier.subresourceRange.levelCount = 1;
+
+		int32_t width = static_cast<int32_t>(extent.width);
+		int32_t height = static_cast<int32_t>(extent.height);
+
+		// every level is written as transfer dst, turned into the source of the next one, then handed to the shaders
+		for (uint32_t level = range.baseMipLevel + 1; level < range.baseMipLevel + range.levelCount; level++) {
+			barrier.subresourceRange.baseMipLevel = level - 1;
+			barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+				.setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+				.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+				.setDstAccessMask(vk::AccessFlagBits::eTransferRead);
+			commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(),
+				0, nullptr,
+				0, nullptr,
+				1, &barrier);
+
+			int32_t nextWidth = (std::max)(width / 2, 1);
+			int32_t nextHeight = (std::max)(height / 2, 1);
+
+			vk::ImageBlit blit = vk::ImageBlit()
+				.setSrcSubresource(vk::ImageSubresourceLayers()
+					.setAspectMask(range.aspectMask)
+					.setMipLevel(level - 1)
+					.setBaseArrayLayer(range.baseArrayLayer)
+					.setLayerCount(range.layerCount))
+				.setDstSubresource(vk::ImageSubresourceLayers()
+					.setAspectMask(range.aspectMask)
+					.setMipLevel(level)
+					.setBaseArrayLayer(range.baseArrayLayer)
+					.setLayerCount(range.layerCount));
+			blit.srcOffsets[1] = vk::Offset3D(width, height, 1);
+			blit.dstOffsets[1] = vk::Offset3D(nextWidth, nextHeight, 1);
+			commandBuffer->blitImage(image, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal, 1, &blit, vk::Filter::eLinear);
+
+			barrier.setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
+				.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+				.setSrcAccessMask(vk::AccessFlagBits::eTransferRead)
+				.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+			commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+				vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader, vk::DependencyFlags(),
+				0, nullptr,
+				0, nullptr,
+				1, &barrier);
+
+			width = nextWidth;
+			height = nextHeight;
+		}
+
+		// the smallest level was only ever written
+		barrier.subresourceRange.baseMipLevel = range.baseMipLevel + range.levelCount - 1;
+		barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+			.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+			.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+		commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+			vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader, vk::DependencyFlags(),
+			0, nullptr,
+			0, nullptr,
+			1, &barrier);
+	}
+
+	uint64_t VulkanUploadManager::queueImageUpdate(UploadBatch::ImageUpdate* update) {
+		vk::CommandBuffer* commandBuffer = beginCommands();
+		if (_separateQueue) {
+			_current->imageUpdates.push_back(std::move(*update));
+		}
+		else {
+			recordImageUpdate(commandBuffer, *update);
+		}
+		return _current->id;
+	}
+
+	void VulkanUploadManager::recordImageUpdate(vk::CommandBuffer* commandBuffer, const UploadBatch::ImageUpdate& update) {
+		bool clear = update.regions.empty();
+
+		// earlier frames may still be sampling the image, the barrier orders the write after them
+		vk::ImageMemoryBarrier toTransfer = vk::ImageMemoryBarrier()
+			.setOldLayout(clear ? vk::ImageLayout::eUndefined : vk::ImageLayout::eShaderReadOnlyOptimal)
+			.setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setImage(update.image)
+			.setSubresourceRange(update.range)
+			.setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+		commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+			vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(),
+			0, nullptr,
+			0, nullptr,
+			1, &toTransfer);
+
+		if (clear) {
+			std::array<float, 4> clearColorValue = { 0.0f, 0.0f, 0.0f, 0.0f };
+			vk::ClearColorValue clearColor = vk::ClearColorValue(clearColorValue);
+			commandBuffer->clearColorImage(update.image, vk::ImageLayout::eTransferDstOptimal, &clearColor, 1, &update.range);
+		}
+		else {
+			commandBuffer->copyBufferToImage(update.srcBuffer, update.image, vk::ImageLayout::eTransferDstOptimal,
+				static_cast<uint32_t>(update.regions.size()), update.regions.data());
+		}
+
+		vk::ImageMemoryBarrier toShaderRead = vk::ImageMemoryBarrier()
+			.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+			.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+			.setImage(update.image)
+			.setSubresourceRange(update.range)
+			.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+			.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+		commandBuffer->pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+			vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader, vk::DependencyFlags(),
+			0, nullptr,
+			0, nullptr,
+			1, &toShaderRead);
+	}
+
+	uint64_t VulkanUploadManager::submitCurrent() {
+		if (!_current->recording) {
+			return _current->id - 1;
+		}
+
+		if (_separateQueue) {
+			submitSeparate(_current);
+		} else {
+			// makes buffer copies visible to whatever the graphics queue submits next, images got their own barrier
+			vk::MemoryBarrier memoryBarrier = vk::MemoryBarrier()
+				.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+				.setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+					vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead);
+			_current->commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+				vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+				vk::DependencyFlags(),
+				1, &memoryBarrier,
+				0, nullptr,
+				0, nullptr);
+
+			_current->commandBuffer.end();
+
+			vk::SubmitInfo submitInfo = vk::SubmitInfo()
+				.setCommandBufferCount(1)
+				.setPCommandBuffers(&_current->commandBuffer);
+
+			if (_queue->submit(1, &submitInfo, _current->fence) != vk::Result::eSuccess) {
+				throw std::runtime_error("failed to submit upload command buffer!");
+			}
+		}
+
+		uint64_t id = _current->id;
+		_pending.push_back(_current);
+		_current = acquireBatch();
+		return id;
+	}
+
+	void VulkanUploadManager::submitSeparate(UploadBatch* batch) {
+		bool ownershipTransfer = _transferFamily != _graphicsFamily;
+
+		// release half, recorded on the transfer queue. the destination stage is ignored for a release
+		std::vector<vk::BufferMemoryBarrier> bufferReleases;
+		if (ownershipTransfer) {
+			bufferReleases = batch->bufferAcquires;
+			for (auto& barrier : bufferReleases) {
+				barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+				barrier.setDstAccessMask(vk::AccessFlags());
+			}
+		}
+		std::vector<vk::ImageMemoryBarrier> imageReleases = batch->imageAcquires;
+		for (auto& barrier : imageReleases) {
+			barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal);
+			barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+			barrier.setDstAccessMask(vk::AccessFlags());
+		}
+
+		if (!bufferReleases.empty() || !imageReleases.empty()) {
+			batch->commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, vk::DependencyFlags(),
+				0, nullptr,
+				static_cast<uint32_t>(bufferReleases.size()), bufferReleases.data(),
+				static_cast<uint32_t>(imageReleases.size()), imageReleases.data());
+		}
+		batch->commandBuffer.end();
+
+		vk::SubmitInfo transferSubmit = vk::SubmitInfo()
+			.setCommandBufferCount(1)
+			.setPCommandBuffers(&batch->commandBuffer)
+			.setSignalSemaphoreCount(1)
+			.setPSignalSemaphores(&batch->semaphore);
+
+		if (_queue->submit(1, &transferSubmit, vk::Fence()) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to submit upload command buffer!");
+		}
+
+		// acquire half on the graphics queue, its barrier carries the semaphore wait on to every later frame
+		vk::CommandBufferBeginInfo beginInfo = vk::CommandBufferBeginInfo()
+			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+		batch->acquireCommandBuffer.begin(&beginInfo);
+		batch->acquireCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+			vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eVertexInput |
+			vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader,
+			vk::DependencyFlags(),
+			0, nullptr,
+			static_cast<uint32_t>(batch->bufferAcquires.size()), batch->bufferAcquires.data(),
+			static_cast<uint32_t>(batch->imageAcquires.size()), batch->imageAcquires.data());
+		for (const auto& mipGeneration : batch->mipGenerations) {
+			recordMipGeneration(&batch->acquireCommandBuffer, mipGeneration.image, mipGeneration.extent, mipGeneration.range);
+		}
+		for (const auto& update : batch->imageUpdates) {
+			recordImageUpdate(&batch->acquireCommandBuffer, update);
+		}
+		batch->acquireCommandBuffer.end();
+
+		vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eTransfer;
+		vk::SubmitInfo acquireSubmit = vk::SubmitInfo()
+			.setWaitSemaphoreCount(1)
+			.setPWaitSemaphores(&batch->semaphore)
+			.setPWaitDstStageMask(&waitStage)
+			.setCommandBufferCount(1)
+			.setPCommandBuffers(&batch->acquireCommandBuffer);
+
+		// the fence sits on the later of the two submissions, so it covers both
+		if (_graphicsQueue->submit(1, &acquireSubmit, batch->fence) != vk::Result::eSuccess) {
+			throw std::runtime_error("failed to submit upload acquire command buffer!");
+		}
+	}
+
+	void VulkanUploadManager::retireCompleted(bool wait) {
+		vk::Device* vkDevice = _logicalDevice->getObject();
+
+		// every batch's fence is signaled on the same queue, so they finish in submission order
+		while (!_pending.empty()) {
+			UploadBatch* batch = _pending.front();
+			if (wait) {
+				vkDevice->waitForFences(1, &batch->fence, VK_TRUE, UINT64_MAX);
+				wait = false;
+			} else if (vkDevice->getFenceStatus(batch->fence) != vk::Result::eSuccess) {
+				break;
+			}
+
+			_pending.pop_front();
+			retireBatch(batch);
+		}
+	}
+
+	void VulkanUploadManager::retireBatch(UploadBatch* batch) {
+		if (batch->usesStaging) {
+			_tail = batch->stagingEnd;
+		}
+		for (size_t i = 0; i < batch->oversizedBuffers.size(); i++) {
+			_logicalDevice->getMemoryAllocator()->destroyBuffer(&batch->oversizedBuffers[i], &batch->oversizedAllocations[i]);
+		}
+		batch->oversizedBuffers.clear();
+		batch->oversizedAllocations.clear();
+
+		_logicalDevice->getObject()->resetFences(1, &batch->fence);
+		batch->commandBuffer.reset(vk::CommandBufferResetFlags());
+		if (_separateQueue) {
+			batch->acquireCommandBuffer.reset(vk::CommandBufferResetFlags());
+			batch->bufferAcquires.clear();
+			batch->imageAcquires.clear();
+			batch->mipGenerations.clear();
+			batch->imageUpdates.clear();
+		}
+		_completedId = batch->id;
+
+		_freeBatches.push_back(batch);
+	}
+}
@@ -0,0 +1,128 @@
+#ifndef VulkanUploadManager_h_
+#define VulkanUploadManager_h_
+
+#include "Base/BaseObject.h"
+#include "VulkanHeader.h"
+#include "VulkanMemoryAllocator.h"
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace litter {
+	class VulkanPhysicalDevice;
+	class VulkanLogicalDevice;
+
+	// copies data to device local buffers and images through one persistently mapped staging ring.
+	// copies and their barriers are collected into a batch that is submitted once per flush with a fence,
+	// nothing waits on the queue. every upload returns the id of the batch it went into, batches complete in order,
+	// so a single id is enough to ask whether everything up to it has landed.
+	// work submitted to the graphics queue after a flush sees the uploaded data without any further waiting.
+	//
+	// copies run on the device's transfer queue. when that is not the graphics queue, each batch signals a semaphore
+	// and a small graphics submission waits on it to acquire the resources, with a queue family ownership transfer
+	// when the families differ. a batch submits to the graphics queue, so flush (and uploads, which flush
+	// when the ring is full) belongs on the thread that submits frames
+	class VulkanUploadManager : public BaseObject {
+	public:
+		VulkanUploadManager(VulkanLogicalDevice* logicalDevice, VulkanPhysicalDevice* physicalDevice, vk::DeviceSize stagingSize);
+		~VulkanUploadManager();
+
+		uint64_t uploadBuffer(vk::Buffer buffer, vk::DeviceSize offset, const void* data, vk::DeviceSize size);
+		// region buffer offsets are relative to data. the image is taken from undefined, so whatever it held is discarded,
+		// and left in shader read only layout for range.
+		// with generateMips the regions only fill range's base level and every further level is blitted from the one above,
+		// which needs eSampledImageFilterLinear and both blit features for the format
+		uint64_t uploadImage(vk::Image image, const void* data, vk::DeviceSize size,
+			const std::vector<vk::BufferImageCopy>& regions, const vk::ImageSubresourceRange& range, bool generateMips);
+		// writes regions of an image that is already in shader read only layout and owned by the graphics queue,
+		// whatever the regions don't cover is kept. runs on the graphics queue, see recordImageUpdate
+		uint64_t updateImage(vk::Image image, const void* data, vk::DeviceSize size,
+			const std::vector<vk::BufferImageCopy>& regions, const vk::ImageSubresourceRange& range);
+		// takes range from undefined to shader read only, cleared to zero, for images that are filled piece by piece
+		uint64_t clearImage(vk::Image image, const vk::ImageSubresourceRange& range);
+
+		// submits what was collected so far and returns its id, cheap when nothing was queued
+		uint64_t flush();
+		bool isComplete(uint64_t id);
+		// flushes first if id is still being collected
+		void wait(uint64_t id);
+
+	private:
+		struct UploadBatch {
+			vk::CommandBuffer commandBuffer;
+			vk::Fence fence;
+			uint64_t id;
+			bool recording;
+			bool usesStaging;
+			// ring position after this batch's last copy, everything before it is free once the fence signals
+			vk::DeviceSize stagingEnd;
+			// uploads larger than the ring get a staging buffer of their own, released with the batch
+			std::vector<vk::Buffer> oversizedBuffers;
+			std::vector<VulkanAllocation> oversizedAllocations;
+
+			// only used when copies run on their own queue
+			vk::Semaphore semaphore;
+			vk::CommandBuffer acquireCommandBuffer;
+			std::vector<vk::BufferMemoryBarrier> bufferAcquires;
+			std::vector<vk::ImageMemoryBarrier> imageAcquires;
+			struct MipGeneration {
+				vk::Image image;
+				vk::Extent3D extent;
+				vk::ImageSubresourceRange range;
+			};
+			std::vector<MipGeneration> mipGenerations;
+			struct ImageUpdate {
+				vk::Image image;
+				vk::ImageSubresourceRange range;
+				// a clear when there are no regions
+				vk::Buffer srcBuffer;
+				std::vector<vk::BufferImageCopy> regions;
+			};
+			std::vector<ImageUpdate> imageUpdates;
+		};
+
+		// writes data to staging memory and returns the buffer and offset to copy from
+		vk::Buffer stage(const void* data, vk::DeviceSize size, vk::DeviceSize* offset);
+		bool tryAllocateStaging(vk::DeviceSize size, vk::DeviceSize* offset);
+		UploadBatch* acquireBatch();
+		vk::CommandBuffer* beginCommands();
+		// blits need a graphics queue, so with a separate transfer queue this runs in the acquire submission
+		void recordMipGeneration(vk::CommandBuffer* commandBuffer, vk::Image image, vk::Extent3D extent, const vk::ImageSubresourceRange& range);
+		// images in use by the graphics queue would need their ownership released to the transfer queue first,
+		// so updates and clears are recorded straight into the acquire submission instead
+		void recordImageUpdate(vk::CommandBuffer* commandBuffer, const UploadBatch::ImageUpdate& update);
+		uint64_t queueImageUpdate(UploadBatch::ImageUpdate* update);
+		uint64_t submitCurrent();
+		void submitSeparate(UploadBatch* batch);
+		void retireCompleted(bool wait);
+		void retireBatch(UploadBatch* batch);
+
+	private:
+		vk::Buffer _stagingBuffer;
+		VulkanAllocation _stagingAllocation;
+		vk::DeviceSize _stagingSize;
+		vk::DeviceSize _alignment;
+		vk::DeviceSize _head;
+		vk::DeviceSize _tail;
+		// both families when they differ, so the staging buffers are shared concurrently
+		std::vector<uint32_t> _stagingFamilies;
+
+		vk::CommandPool _commandPool;
+		vk::CommandPool _acquireCommandPool;
+		vk::Queue* _queue;
+		vk::Queue* _graphicsQueue;
+		bool _separateQueue;
+		uint32_t _transferFamily;
+		uint32_t _graphicsFamily;
+		UploadBatch* _current;
+		std::deque<UploadBatch*> _pending;
+		std::vector<UploadBatch*> _freeBatches;
+		uint64_t _nextId;
+		uint64_t _completedId;
+		std::mutex _mutex;
+
+		VulkanLogicalDevice* _logicalDevice;
+	};
+}
+
+#endif // !VulkanUploadManager_h_
@@ -1,7 +1,7 @@
-#include "VulkanUtils\VulkanApplication.h"
+#include "VulkanUtils/VulkanApplication.h"
 #include "StdC.h"
 
-int main() {
+int main(int argc, char* argv[]) {
 
 	/*const std::vector<Vertex> vertices = {
 		{ { 0.0f, -0.5f },{ 1.0f, 0.0f, 0.0f } },
@@ -11,6 +11,32 @@ int main() {
 
 	VulkanApplication app;
 
+	// --headless [frames]: render offscreen without a window and report frame timings
+	// --profile <trace.json>: write cpu/gpu zones for chrome://tracing or perfetto
+	// --mesh <model.obj|.gltf|.glb>: draw a model instead of the textured quad
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--headless") == 0) {
+			uint32_t frames = 1000;
+			// the frame count is optional, a following option is left for the next iteration
+			if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+				char* end = nullptr;
+				unsigned long count = strtoul(argv[++i], &end, 10);
+				if (argv[i][0] < '0' || argv[i][0] > '9' || *end != '\0' || count == 0 || count > UINT32_MAX) {
+					std::cerr << "--headless expects a frame count above zero, got " << argv[i] << std::endl;
+					return EXIT_FAILURE;
+				}
+				frames = static_cast<uint32_t>(count);
+			}
+			app.setHeadless(1280, 720, frames);
+		}
+		else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+			app.setProfileOutput(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--mesh") == 0 && i + 1 < argc) {
+			app.setMeshPath(argv[++i]);
+		}
+	}
+
 	try {
 		app.init();
 		app.run();
@@ -1,3 +0,0 @@
-D:/work/sdk/vulkanSDK/1.0.49.0/Bin/glslangValidator.exe -V shader.vert
-D:/work/sdk/vulkanSDK/1.0.49.0/Bin/glslangValidator.exe -V shader.frag
-pause
\ No newline at end of file
@@ -1,12 +1,17 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(binding = 1) uniform sampler2D texSampler;
+// the texture table, the size has to match TEXTURE_TABLE_SIZE
+layout(set = 1, binding = 0) uniform sampler2D textures[64];
+
+layout(push_constant) uniform PushConstants {
+    layout(offset = 64) uint textureIndex;
+} object;
 
 layout(location = 0) in vec2 fragTexCoord;
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = texture(texSampler, fragTexCoord);
+    outColor = texture(textures[object.textureIndex], fragTexCoord);
 }
\ No newline at end of file